@@ -78,6 +78,8 @@ function(sc_add_server_plugin dest_dir name cpp sc schelp)
     if(schelp)
         install(FILES ${schelp} DESTINATION ${dest_dir}/HelpSource/Classes)
     endif()
+
+    set(all_sc_server_plugins ${all_sc_server_plugins} PARENT_SCOPE)
 endfunction()
 
 set(all_sc_server_plugins)
@@ -2,14 +2,28 @@
 // toneburst (the_voder@yahoo.co.uk)
 
 #include <iostream> // For cout
+#include <algorithm> // For std::min
+#include <atomic> // For the current square table, read by UGens on several threads
+#include <memory> // For std::align
+#include <new> // For placement new
 
 #include "SC_PlugIn.hpp"
 
-// Include Open303 DSP header
-#include "lib/Open303/Source/DSPCode/rosic_Open303.h"
+// Scoped flush-to-zero of denormals while rendering
+#include "lib/Open303/Source/DSPCode/tbrst_DenormalGuard.h"
+
+// Instruction set variants of the render loops, selected at plugin load
+#include "lib/Open303/Source/DSPCode/tbrst_Open303Kernels.h"
+
+// Cache of rendered square-wave tables (for the shaper command)
+#include "lib/Open303/Source/DSPCode/tbrst_WaveTableCache.h"
+
+// Pool of constructed synth engines (for the prewarm command)
+#include "lib/Open303/Source/DSPCode/tbrst_Open303Pool.h"
 
 // Global functions (for parameter scaling)
 #include "lib/Open303/Source/DSPCode/GlobalFunctions.h" // For parameter range functions (linToExp, linToLin, etc.)
+#include "lib/Open303/Source/DSPCode/rosic_RealFunctions.h" // For the table-based mapping of audio-rate inputs (linToExpLookup, exp2Lookup)
 
 #include "Open303.hpp"
 
@@ -17,8 +31,130 @@ static InterfaceTable* ft;
 
 namespace Open303 {
 
-    // Instantiate Open303 object
-    rosic::Open303 o303;
+    // Rendered square-wave tables, keyed by shaper parameters. Tables are rendered by the
+    // open303SquareShaper command on the NRT thread and swapped in by the UGens.
+    rosic::WaveTableCache squareTableCache;
+
+    // Square-wave table set by the most recent open303SquareShaper command (NULL = built-in).
+    // Written on the RT thread, read by the UGens (on several threads in a supernova ParGroup).
+    // Holds one reference in squareTableCache.
+    std::atomic<rosic::MipMappedWaveTable*> currentSquareTable{NULL};
+
+    // Synth engines constructed by the open303Prewarm command on the NRT thread, taken by the UGens
+    // when they start and given back when they end. Only used on the RT thread.
+    rosic::Open303Pool enginePool;
+
+    /////////////////////////////////
+    // Square Shaper Async Command //
+    /////////////////////////////////
+
+    struct SquareShaperCmdData {
+        rosic::WaveTableKey        key;
+        rosic::MipMappedWaveTable* table; // newly acquired table, then the one it replaced
+    };
+
+    // Stage 2 (NRT thread): look up the table for the new shaper settings, render if not cached
+    bool squareShaperCmdStage2(World*, void* inUserData) {
+        SquareShaperCmdData* data = static_cast<SquareShaperCmdData*>(inUserData);
+        data->table = squareTableCache.acquire(data->key);
+        if(data->table == NULL) {
+            Print("Open303: square shaper table cache is full, command ignored\n");
+            return false;
+        }
+        return true;
+    }
+
+    // Stage 3 (RT thread): make the new table current. UGens pick it up at their next block.
+    bool squareShaperCmdStage3(World*, void* inUserData) {
+        SquareShaperCmdData* data = static_cast<SquareShaperCmdData*>(inUserData);
+        data->table = currentSquareTable.exchange(data->table);
+        return true;
+    }
+
+    // Stage 4 (NRT thread): drop the reference held on the replaced table
+    bool squareShaperCmdStage4(World*, void* inUserData) {
+        SquareShaperCmdData* data = static_cast<SquareShaperCmdData*>(inUserData);
+        squareTableCache.release(data->table);
+        return true;
+    }
+
+    void squareShaperCmdCleanup(World* world, void* inUserData) {
+        RTFree(world, inUserData);
+    }
+
+    // /cmd open303SquareShaper drive offset phaseShift
+    // Sets the tanh-shaper drive (dB), offset and phase-shift (degrees) of the 303 square wave
+    void squareShaperCmd(World* world, void*, struct sc_msg_iter* args, void* replyAddr) {
+        SquareShaperCmdData* data = static_cast<SquareShaperCmdData*>(RTAlloc(world, sizeof(SquareShaperCmdData)));
+        if(data == NULL)
+            return;
+        data->key.waveform         = rosic::MipMappedWaveTable::SQUARE303;
+        data->key.symmetry         = 0.5;
+        data->key.tanhShaperDrive  = args->getf(36.9f);
+        data->key.tanhShaperOffset = args->getf(4.37f);
+        data->key.squarePhaseShift = args->getf(180.0f);
+        data->table                = NULL;
+        DoAsynchronousCommand(world, replyAddr, "open303SquareShaper", data,
+            squareShaperCmdStage2, squareShaperCmdStage3, squareShaperCmdStage4, squareShaperCmdCleanup,
+            0, NULL);
+    }
+
+    ///////////////////////////
+    // Prewarm Async Command //
+    ///////////////////////////
+
+    struct PrewarmCmdData {
+        int             numWanted;  // engines the pool should hold
+        double          sampleRate;
+        int             numEngines; // engines constructed, then the ones the pool didn't take
+        rosic::Open303* engines[rosic::Open303Pool::maxNumEngines];
+    };
+
+    // Stage 2 (NRT thread): construct the engines the pool is missing
+    bool prewarmCmdStage2(World*, void* inUserData) {
+        PrewarmCmdData* data = static_cast<PrewarmCmdData*>(inUserData);
+        data->numEngines = enginePool.getNumMissing(data->numWanted);
+        for(int i = 0; i < data->numEngines; ++i) {
+            data->engines[i] = new rosic::Open303;
+            data->engines[i]->setSampleRate(data->sampleRate);
+        }
+        return true;
+    }
+
+    // Stage 3 (RT thread): add the engines to the pool
+    bool prewarmCmdStage3(World*, void* inUserData) {
+        PrewarmCmdData* data = static_cast<PrewarmCmdData*>(inUserData);
+        data->numEngines = enginePool.add(data->engines, data->numEngines);
+        return true;
+    }
+
+    // Stage 4 (NRT thread): delete the engines that didn't fit into the pool anymore (if the
+    // command was sent again before this one got to stage 3)
+    bool prewarmCmdStage4(World*, void* inUserData) {
+        PrewarmCmdData* data = static_cast<PrewarmCmdData*>(inUserData);
+        for(int i = 0; i < data->numEngines; ++i)
+            delete data->engines[i];
+        return true;
+    }
+
+    void prewarmCmdCleanup(World* world, void* inUserData) {
+        RTFree(world, inUserData);
+    }
+
+    // /cmd open303Prewarm numEngines
+    // Fills the engine pool up to numEngines free engines, so that starting that many synths
+    // doesn't construct any engines on the RT thread
+    void prewarmCmd(World* world, void*, struct sc_msg_iter* args, void* replyAddr) {
+        PrewarmCmdData* data = static_cast<PrewarmCmdData*>(RTAlloc(world, sizeof(PrewarmCmdData)));
+        if(data == NULL)
+            return;
+        data->numWanted  = args->geti(16);
+        data->sampleRate = world->mFullRate.mSampleRate;
+        data->numEngines = 0;
+        DoAsynchronousCommand(world, replyAddr, "open303Prewarm", data,
+            prewarmCmdStage2, prewarmCmdStage3, prewarmCmdStage4, prewarmCmdCleanup,
+            0, NULL);
+    }
 
     // CONSTRUCTOR
     Open303::Open303() {
@@ -32,20 +168,91 @@ namespace Open303 {
         m_accent    = in0(ACCENT);
         m_volume    = in0(VOLUME);
         m_extmix    = in0(EXTMIX);
+        m_sublevel  = clamp(in0(SUBLEVEL), 0.0, 1.0);
+        m_noisemix  = clamp(in0(NOISEMIX), 0.0, 1.0);
+        m_distdrive = linToLin(in0(DISTDRIVE), 0.0, 1.0, 0.0, 24.0);
+        m_disttone  = -1.0; // Forces tone filter setup in first call to next()
 
         // Get Sample-Rate
         m_sRate = fullSampleRate();
 
-        // Set Open303 sample-rate
-        o303.setSampleRate(m_sRate);
+        // Take a synth engine from the pool. If the pool is empty, allocate and construct one,
+        // with room to align it to a cache line. Without an engine the synth only outputs silence
+        m_engine = enginePool.get();
+        if(m_engine == NULL) {
+            size_t engineSpace = sizeof(rosic::Open303) + alignof(rosic::Open303);
+            m_engineMemory = RTAlloc(mWorld, engineSpace);
+            if(m_engineMemory == NULL) {
+                Print("Open303: could not allocate the synth engine\n");
+                mCalcFunc = ft->fClearUnitOutputs;
+                ClearUnitOutputs(this, 1);
+                return;
+            }
+            void* engineAddress = m_engineMemory;
+            std::align(alignof(rosic::Open303), sizeof(rosic::Open303), engineAddress, engineSpace);
+            m_engine = new(engineAddress) rosic::Open303;
+        }
+        rosic::Open303& o303 = *m_engine;
+
+        // Set Open303 sample-rate (pooled engines usually have it already)
+        if(o303.getSampleRate() != m_sRate)
+            o303.setSampleRate(m_sRate);
+
+        // Seed the noise generator from the synth's random generator (so RandSeed applies)
+        o303.setNoiseSeed(mParent->mRGen->trand());
 
-        mCalcFunc = make_calc_function<Open303, &Open303::next>();
-        next(1);
+        // Pick the calc function for the external input path and the modulation inputs. The
+        // external input stays off if extmix is a constant 0, and is only read per sample if extin
+        // is audio rate. Cutoff, pitchbend and filtermorph are only read per sample if one of them
+        // is audio rate
+        int extInPath = EXTIN_CONTROL;
+        if(isScalarRateIn(EXTMIX) && in0(EXTMIX) == 0.f)
+            extInPath = EXTIN_OFF;
+        else if(isAudioRateIn(EXTIN))
+            extInPath = EXTIN_AUDIO;
+        const bool audioRateMod = isAudioRateIn(CUTOFF) || isAudioRateIn(PITCHBEND) || isAudioRateIn(FILTERMORPH);
+        mCalcFunc = audioRateMod ? calcFunction<true>(extInPath) : calcFunction<false>(extInPath);
+        (mCalcFunc)(this, 1);
     
     } // End Open303 constructor
 
+    // DESTRUCTOR
+    Open303::~Open303() {
+        if(m_engine == NULL)
+            return;
+        // Drop the reference on the square-wave table this synth switched to (if any)
+        squareTableCache.release(m_engine->getSquareWaveTable());
+        if(m_engineMemory == NULL) {
+            // Give the engine back to the pool, with the built-in square table
+            m_engine->setSquareWaveTable(NULL);
+            enginePool.put(m_engine);
+        }
+        else {
+            m_engine->~Open303();
+            RTFree(mWorld, m_engineMemory);
+        }
+    }
+
+    // Calc function for an external input path, with or without audio-rate modulation inputs
+    template <bool AudioRateMod>
+    UnitCalcFunc Open303::calcFunction(int extInPath) {
+        switch(extInPath) {
+            case EXTIN_OFF:   return make_calc_function<Open303, &Open303::next<EXTIN_OFF,     AudioRateMod>>();
+            case EXTIN_AUDIO: return make_calc_function<Open303, &Open303::next<EXTIN_AUDIO,   AudioRateMod>>();
+            default:          return make_calc_function<Open303, &Open303::next<EXTIN_CONTROL, AudioRateMod>>();
+        }
+    }
+
     // Control-rate loop
+    template <int ExtInPath, bool AudioRateMod>
     void Open303::next(int nSamples) {
+
+#ifdef OPEN303_FLUSH_DENORMALS
+        // Flush denormals to zero while rendering (the filters don't add TINY against them then)
+        rosic::DenormalGuard denormalGuard;
+#endif
+
+        rosic::Open303& o303 = *m_engine;
         
         ////////////////////////
         // Control Parameters //
@@ -78,6 +285,37 @@ namespace Open303 {
         const float filterMorphParam         = linToLin(in0(FILTERMORPH),  0.0, 1.0,   0.0, 0.9999); // Set range to 0.9999 to avoid linear blend glitch (should no longer be necessary when using std::lerp, but apparently still is....)
         const float extmixParam              = linToLin(in0(EXTMIX),       0.0, 1.0,   0.0,    1.0); // External input mix
 
+        // Oscillator wavetable interpolation (0 = linear, 1 = cubic Hermite, 2 = 4-point Lagrange)
+        const int   interpolationParam       = static_cast<int>(in0(INTERPOLATION));
+
+        // Oscillator backend (0 = mip-mapped wavetables, 1 = table-free PolyBLEP)
+        const int   oscModeParam             = static_cast<int>(in0(OSCMODE));
+
+        // Sub-oscillator level and octave (1 or 2 octaves below the oscillator)
+        const float subLevelParam            = clamp(in0(SUBLEVEL),        0.0, 1.0);     // No scaling required (already in 0-1 range)
+        const int   subOctaveParam           = static_cast<int>(in0(SUBOCTAVE));
+
+        // Noise mix and type (0 = white, 1 = pitch-tracking sample-and-hold)
+        const float noiseMixParam            = clamp(in0(NOISEMIX),        0.0, 1.0);     // No scaling required (already in 0-1 range)
+        const int   noiseModeParam           = static_cast<int>(in0(NOISEMODE));
+
+        // Post-filter drive (0 = off, 1 = soft clip, 2 = hard clip, 3 = asymmetric, 4 = tanh), drive and tone
+        const int   distModeParam            = static_cast<int>(in0(DISTMODE));
+        const float distDriveParam           = linToLin(in0(DISTDRIVE),    0.0, 1.0,   0.0,   24.0); // Gain into the shaper (dB)
+        const float distToneParam            = linToExp(in0(DISTTONE),     0.0, 1.0, 500.0, 20000.0); // Tone lowpass cutoff (Hz)
+
+        // Drive evaluation (0 = oversampled, 1/2 = base rate with 1st/2nd order antiderivative anti-aliasing)
+        const int   distRateParam            = static_cast<int>(in0(DISTRATE));
+
+        // Filter ladder solution (0 = standard, 1 = zero-delay feedback, 2 = nonlinear)
+        const int   ladderModeParam          = static_cast<int>(in0(LADDERMODE));
+
+        // Samples between updates of the envelope-driven filter cutoff (1, 4, 8 or 16)
+        const int   modRateParam             = static_cast<int>(in0(MODRATE));
+
+        // Filter cutoff modulation by the oscillator (octaves at full oscillator amplitude)
+        const float filterFmParam            = linToLin(clamp(in0(FILTERFM), 0.0, 1.0), 0.0, 1.0, 0.0, 2.0);
+
         // Create interpolation slopes
         // The slope signal is used to interpolate between the last value and the new value within the audio render loop
         SlopeSignal<float> slopedPitchbend   = makeSlope(pitchbendParam,   m_pitchbend);
@@ -90,6 +328,17 @@ namespace Open303 {
         SlopeSignal<float> slopedVolume      = makeSlope(volumeParam,      m_volume);
         SlopeSignal<float> slopedFilterMorph = makeSlope(filterMorphParam, m_filtermorph);
         SlopeSignal<float> slopedExtmix      = makeSlope(extmixParam,      m_extmix);
+        SlopeSignal<float> slopedSubLevel    = makeSlope(subLevelParam,    m_sublevel);
+        SlopeSignal<float> slopedNoiseMix    = makeSlope(noiseMixParam,    m_noisemix);
+        SlopeSignal<float> slopedDistDrive   = makeSlope(distDriveParam,   m_distdrive);
+
+        // Audio-rate modulation inputs are mapped and set per sample instead of ramped
+        const bool cutoffAudioRate           = AudioRateMod && isAudioRateIn(CUTOFF);
+        const bool pitchbendAudioRate        = AudioRateMod && isAudioRateIn(PITCHBEND);
+        const bool filterMorphAudioRate      = AudioRateMod && isAudioRateIn(FILTERMORPH);
+        if(cutoffAudioRate)      slopedCutoff      = SlopeSignal<float>(cutoffParam,      0.f);
+        if(pitchbendAudioRate)   slopedPitchbend   = SlopeSignal<float>(pitchbendParam,   0.f);
+        if(filterMorphAudioRate) slopedFilterMorph = SlopeSignal<float>(filterMorphParam, 0.f);
 
         ///////////////////
         // Note-Handling //
@@ -122,6 +371,34 @@ namespace Open303 {
             o303.allNotesOff();
         }
 
+        ///////////////////////
+        // Square Table Swap //
+        ///////////////////////
+
+        // Switch to the square-wave table of the latest shaper command (if it changed)
+        rosic::MipMappedWaveTable* squareTable = currentSquareTable.load();
+        if(squareTable != NULL && squareTable != o303.getSquareWaveTable()) {
+            squareTableCache.retain(squareTable);
+            squareTableCache.release(o303.getSquareWaveTable());
+            o303.setSquareWaveTable(squareTable);
+        }
+
+        o303.setOscillatorInterpolation(interpolationParam);
+        o303.setOscillatorBackend(oscModeParam);
+        o303.setSubOscOctave(subOctaveParam);
+        o303.setNoiseMode(noiseModeParam);
+        o303.setDriveMode(distModeParam);
+        o303.setDriveAtBaseRate(distRateParam > 0);
+        o303.setDriveAntiAliasing(distRateParam > 0 ? distRateParam : rosic::DriveStage::NO_ANTI_ALIASING);
+        o303.setFilterLadder(ladderModeParam);
+        o303.setModulationSubRate(modRateParam);
+        o303.setFilterFm(filterFmParam);
+        if(distToneParam != m_disttone) {
+            // Only recalculate the tone filter coefficients on change
+            o303.setDriveTone(distToneParam);
+            m_disttone = distToneParam;
+        }
+
         //////////////////
         // Audio Render //
         //////////////////
@@ -129,26 +406,80 @@ namespace Open303 {
         // Create output buffer
         float* outbuf = out(0);
 
-        // Fill output buffer with nSamples Open303 synth samples
-        for (int i = 0; i < nSamples; ++i) {
-            
-            // Update synth params with interpolated value
-            // Cast floats to doubles
-            o303.setPitchBend(   static_cast<double>(slopedPitchbend.consume()));
-            o303.setWaveform(    static_cast<double>(slopedWaveform.consume()));
-            o303.setCutoff(      static_cast<double>(slopedCutoff.consume()));
-            o303.setResonance(   static_cast<double>(slopedResonance.consume()));
-            o303.setEnvMod(      static_cast<double>(slopedEnvmod.consume()));
-            o303.setDecay(       static_cast<double>(slopedDecay.consume()));
-            o303.setAccent(      static_cast<double>(slopedAccent.consume()));
-            o303.setVolume(      static_cast<double>(slopedVolume.consume()));
-            o303.setFilterMorph( static_cast<double>(slopedFilterMorph.consume()));
+        // External input. Only an audio-rate input with a nonzero mix is passed per sample
+        const float* extinbuf = in(EXTIN);
+        const bool extinPerSample = (ExtInPath == EXTIN_AUDIO) && (extmixParam != 0.f);
+        if(ExtInPath != EXTIN_OFF && !extinPerSample)
+            o303.setExtIn(extmixParam, static_cast<double>(extinbuf[0]));
+
+        // Set all params once for the block (cast floats to doubles). Only those that changed since
+        // the last block are updated again per sample below
+        o303.setPitchBend(   static_cast<double>(slopedPitchbend.value));
+        o303.setWaveform(    static_cast<double>(slopedWaveform.value));
+        o303.setCutoff(      static_cast<double>(slopedCutoff.value));
+        o303.setResonance(   static_cast<double>(slopedResonance.value));
+        o303.setEnvMod(      static_cast<double>(slopedEnvmod.value));
+        o303.setDecay(       static_cast<double>(slopedDecay.value));
+        o303.setAccent(      static_cast<double>(slopedAccent.value));
+        o303.setVolume(      static_cast<double>(slopedVolume.value));
+        o303.setFilterMorph( static_cast<double>(slopedFilterMorph.value));
+        o303.setSubOscLevel( static_cast<double>(slopedSubLevel.value));
+        o303.setNoiseMix(    static_cast<double>(slopedNoiseMix.value));
+        o303.setDrive(       static_cast<double>(slopedDistDrive.value));
+
+        const bool ramping = slopedPitchbend.slope != 0.f || slopedWaveform.slope != 0.f
+            || slopedCutoff.slope != 0.f || slopedResonance.slope != 0.f || slopedEnvmod.slope != 0.f
+            || slopedDecay.slope != 0.f || slopedAccent.slope != 0.f || slopedVolume.slope != 0.f
+            || slopedFilterMorph.slope != 0.f || slopedSubLevel.slope != 0.f
+            || slopedNoiseMix.slope != 0.f || slopedDistDrive.slope != 0.f;
+
+        // Fill output buffer with nSamples Open303 synth samples, rendered in blocks so the filters
+        // behind the decimation run over each block in one go. Rendering goes through the kernels
+        // for the instruction set selected at plugin load
+        for (int blockStart = 0; blockStart < nSamples; blockStart += rosic::Open303::maxBlockSize) {
+            const int blockEnd = std::min(nSamples, blockStart + rosic::Open303::maxBlockSize);
+
+            if (!ramping && !extinPerSample && !AudioRateMod) {
+                // Common case: nothing changes within the block
+                rosic::Open303Kernels::render(o303, blockEnd - blockStart);
+                rosic::Open303Kernels::finish(o303, outbuf + blockStart);
+                continue;
+            }
+
+            for (int i = blockStart; i < blockEnd; ++i) {
             
-            // Set external input mix level and pass sample of ext input (cast to double)
-            o303.setExtIn(extmixParam, static_cast<double>(in(EXTIN)[i]));
+                // Update the ramping synth params with interpolated value
+                if (ramping) {
+                    if (slopedPitchbend.slope != 0.f)   o303.setPitchBend(   static_cast<double>(slopedPitchbend.consume()));
+                    if (slopedWaveform.slope != 0.f)    o303.setWaveform(    static_cast<double>(slopedWaveform.consume()));
+                    if (slopedCutoff.slope != 0.f)      o303.setCutoff(      static_cast<double>(slopedCutoff.consume()));
+                    if (slopedResonance.slope != 0.f)   o303.setResonance(   static_cast<double>(slopedResonance.consume()));
+                    if (slopedEnvmod.slope != 0.f)      o303.setEnvMod(      static_cast<double>(slopedEnvmod.consume()));
+                    if (slopedDecay.slope != 0.f)       o303.setDecay(       static_cast<double>(slopedDecay.consume()));
+                    if (slopedAccent.slope != 0.f)      o303.setAccent(      static_cast<double>(slopedAccent.consume()));
+                    if (slopedVolume.slope != 0.f)      o303.setVolume(      static_cast<double>(slopedVolume.consume()));
+                    if (slopedFilterMorph.slope != 0.f) o303.setFilterMorph( static_cast<double>(slopedFilterMorph.consume()));
+                    if (slopedSubLevel.slope != 0.f)    o303.setSubOscLevel( static_cast<double>(slopedSubLevel.consume()));
+                    if (slopedNoiseMix.slope != 0.f)    o303.setNoiseMix(    static_cast<double>(slopedNoiseMix.consume()));
+                    if (slopedDistDrive.slope != 0.f)   o303.setDrive(       static_cast<double>(slopedDistDrive.consume()));
+                }
+
+                // Map and set the audio-rate modulation inputs (with table lookups instead of exp)
+                if (cutoffAudioRate)
+                    o303.setCutoff(rosic::linToExpLookup(in(CUTOFF)[i], 0.0, 1.0, 314.0, 2394.0));
+                if (pitchbendAudioRate)
+                    o303.setPitchBendFactor(rosic::exp2Lookup(clamp(in(PITCHBEND)[i], -12.0, 12.0) / 12.0));
+                if (filterMorphAudioRate)
+                    o303.setFilterMorph(linToLin(in(FILTERMORPH)[i], 0.0, 1.0, 0.0, 0.9999));
+
+                // Set external input mix level and pass sample of ext input (cast to double)
+                if (extinPerSample)
+                    o303.setExtIn(extmixParam, static_cast<double>(extinbuf[i]));
 
-            // Call Open303 render function
-            outbuf[i] = o303.getSample();
+                // Call Open303 render function
+                rosic::Open303Kernels::render(o303, 1);
+            }
+            rosic::Open303Kernels::finish(o303, outbuf + blockStart);
         }
 
         ////////////////////////
@@ -165,6 +496,9 @@ namespace Open303 {
         m_volume        = slopedVolume.value;
         m_filtermorph   = slopedFilterMorph.value;
         m_extmix        = slopedExtmix.value;
+        m_sublevel      = slopedSubLevel.value;
+        m_noisemix      = slopedNoiseMix.value;
+        m_distdrive     = slopedDistDrive.value;
 
         ///////////////////////////////
         // Update Previous Gate/Note //
@@ -181,5 +515,9 @@ namespace Open303 {
 PluginLoad(Open303UGens) {
     // Plugin magic
     ft = inTable;
+    // Use the best variant of the render loops the CPU supports
+    rosic::Open303Kernels::select(rosic::Open303Kernels::detectInstructionSet());
     registerUnit<Open303::Open303>(ft, "Open303", false);
+    DefinePlugInCmd("open303SquareShaper", Open303::squareShaperCmd, nullptr);
+    DefinePlugInCmd("open303Prewarm", Open303::prewarmCmd, nullptr);
 }
@@ -9,6 +9,9 @@
 
 #include "SC_PlugIn.hpp"
 
+// Include Open303 DSP header
+#include "lib/Open303/Source/DSPCode/rosic_Open303.h"
+
 namespace Open303 {
 
 class Open303 : public SCUnit {
@@ -19,6 +22,12 @@ public:
 
   Open303();
 
+  ////////////////
+  // Destructor //
+  ////////////////
+
+  ~Open303();
+
 private:
 
   /////////////////////
@@ -44,6 +53,10 @@ private:
   float m_filtermorph;
   float m_distortion;
   float m_extmix;
+  float m_sublevel;
+  float m_noisemix;
+  float m_distdrive;
+  float m_disttone;
 
   // Input indices enumeration
   enum inputs {
@@ -61,15 +74,48 @@ private:
     VOLUME,
     FILTERMORPH,
     EXTMIX,
-    EXTIN = 14
+    EXTIN = 14,
+    INTERPOLATION,
+    OSCMODE,
+    SUBLEVEL,
+    SUBOCTAVE,
+    NOISEMIX,
+    NOISEMODE,
+    DISTMODE,
+    DISTDRIVE,
+    DISTTONE,
+    DISTRATE,
+    LADDERMODE,
+    MODRATE,
+    FILTERFM
   };
 
-  // Calc function
+  // External input paths, one calc function each
+  enum extInPaths {
+    EXTIN_OFF = 0, // extmix is a constant 0
+    EXTIN_CONTROL, // extin is not audio rate, read once per block
+    EXTIN_AUDIO    // extin is audio rate, read per sample
+  };
+
+  // Calc function for an external input path, optionally reading cutoff, pitchbend and
+  // filtermorph per sample
+  template <int ExtInPath, bool AudioRateMod>
   void next(int nSamples);
 
+  // Returns the calc function for an external input path
+  template <bool AudioRateMod>
+  UnitCalcFunc calcFunction(int extInPath);
+
   //////////////////////
   // Member Variables //
   //////////////////////
+
+  // Synth engine. One per UGen, so synths don't share state and can run in parallel (supernova
+  // ParGroups). Taken from the engine pool, or if that is empty allocated with RTAlloc and
+  // aligned by hand, because rosic::Open303 keeps its per-sample state on cache-line boundaries
+  // and neither RTAlloc nor the unit's own memory promise that alignment
+  void*           m_engineMemory{NULL}; // NULL if the engine is from the pool
+  rosic::Open303* m_engine{NULL};
 };
 
 } // End namespace Open303
@@ -7,10 +7,22 @@ Open303 : UGen {
 	// 'noteevent' parameter going positive will trigger a new Open303 note event (noteOn or noteOff)
 	// noteevent must go positive for only one k-rate cycle for each note-on/off received!!
 	// Defaults values from Open303VST.cpp starting at line 14
-	*ar{ | gate = 0.0, notenum=60.0, notevel=64.0, notealloff=0.0, pitchbend=0.0, waveform=0.85, cutoff=0.229, resonance=0.5, envmod=0.25, decay=0.5, accent=0.5, volume=0.9, filtermorph=0.0, extmix=0.0, extin=0.0 |
-      ^this.multiNew('audio', gate, notenum, notevel, notealloff, pitchbend, waveform, cutoff, resonance, envmod, decay, accent, volume, filtermorph, extmix, extin);
+	*ar{ | gate = 0.0, notenum=60.0, notevel=64.0, notealloff=0.0, pitchbend=0.0, waveform=0.85, cutoff=0.229, resonance=0.5, envmod=0.25, decay=0.5, accent=0.5, volume=0.9, filtermorph=0.0, extmix=0.0, extin=0.0, interpolation=0, oscmode=0, sublevel=0.0, suboctave=2, noisemix=0.0, noisemode=0, distmode=0, distdrive=0.5, disttone=1.0, distrate=0, laddermode=0, modrate=1, filterfm=0.0 |
+      ^this.multiNew('audio', gate, notenum, notevel, notealloff, pitchbend, waveform, cutoff, resonance, envmod, decay, accent, volume, filtermorph, extmix, extin, interpolation, oscmode, sublevel, suboctave, noisemix, noisemode, distmode, distdrive, disttone, distrate, laddermode, modrate, filterfm);
     }
 
+	// Sets the tanh-shaper of the 303 square wave for all running Open303 instances.
+	// Tables are rendered (and cached) on the server's non-realtime thread, so this is safe to call while playing.
+	*squareShaper { | server, drive=36.9, offset=4.37, phaseshift=180.0 |
+		(server ? Server.default).sendMsg(\cmd, \open303SquareShaper, drive, offset, phaseshift);
+	}
+
+	// Fills the server's pool of synth engines up to numengines free engines.
+	// Engines are constructed on the server's non-realtime thread, so synths started later don't construct them on the audio thread.
+	*prewarm { | server, numengines=16 |
+		(server ? Server.default).sendMsg(\cmd, \open303Prewarm, numengines);
+	}
+
 	checkInputs {		
 		// Input rate-checking
         [0, 1].do { |i|
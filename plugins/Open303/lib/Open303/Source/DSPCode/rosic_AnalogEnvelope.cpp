@@ -146,7 +146,10 @@ void AnalogEnvelope::setPeakScale(double newPeakScale)
 
 void AnalogEnvelope::reset()
 {
-  time = 0.0;
+  time           = 0.0;
+  previousOutput = 0.0;
+  noteIsOn       = false;
+  outputIsZero   = true;
 }
 
 void AnalogEnvelope::noteOn(bool startFromCurrentLevel, int newKey, int newVel)
@@ -157,7 +157,7 @@ namespace rosic
     /** Causes the envelope to start with its release-phase. */
     void noteOff();  
 
-    /** Resets the time variable. */
+    /** Resets the time variable and the output to zero and ends the note. */
     void reset();   
 
   protected:
@@ -3,6 +3,7 @@
 
 // rosic-indcludes:
 #include "rosic_RealFunctions.h"
+#include "tbrst_DenormalGuard.h" // for ANTI_DENORMAL
 
 namespace rosic
 {
@@ -75,6 +76,11 @@ namespace rosic
     /** Returns the bandwidth in octaves. */
     double getBandwidth() const { return bandwidth; }
 
+    /** Returns the filter coefficients (for 
+    y[n] = b0*x[n] + b1*x[n-1] + b2*x[n-2] + a1*y[n-1] + a2*y[n-2]). */
+    void getCoefficients(double *b0, double *b1, double *b2, double *a1, double *a2) const
+    { *b0 = this->b0; *b1 = this->b1; *b2 = this->b2; *a1 = this->a1; *a2 = this->a2; }
+
     //---------------------------------------------------------------------------------------------
     // audio processing:
 
@@ -109,7 +115,7 @@ namespace rosic
   INLINE double BiquadFilter::getSample(double in)
   {
     // calculate the output sample:
-    double y = b0*in + b1*x1 + b2*x2 + a1*y1 + a2*y2 + TINY;
+    double y = ANTI_DENORMAL(b0*in + b1*x1 + b2*x2 + a1*y1 + a2*y2);
 
     // update the buffer variables:
     x2 = x1;
@@ -11,15 +11,24 @@ BlendOscillator::BlendOscillator()
   sampleRate           = 44100.0;
   freq                 = 440.0;
   increment            = (tableLengthDbl*freq)/sampleRate;
-  phaseIndex           = 0.0;
+  blend                = 0.0;
+  phase                = 0;
+  cycleCount           = 0;
+  phaseIncrement       = 0;
+  tableNumber          = -1;
   startIndex           = 0.0;
   waveTable1           = NULL;
   waveTable2           = NULL;
+  interpolation        = MipMappedWaveTable::LINEAR;
+  backend              = WAVETABLE;
+  cycleIncrement       = 0.0;
 
   // somewhat redundant:
   setSampleRate(44100.0);          // sampleRate = 44100 Hz by default
   setFrequency (440.0);            // frequency = 440 Hz by default
   setStartPhase(0.0);              // startPhase = 0 by default
+  setSquareShape(MipMappedWaveTable::defaultTanhShaperDrive, 
+    MipMappedWaveTable::defaultTanhShaperOffset, MipMappedWaveTable::default303SquarePhaseShift);
 
   setWaveForm1(MipMappedWaveTable::SAW);
   setWaveForm2(MipMappedWaveTable::SQUARE);
@@ -40,7 +49,7 @@ void BlendOscillator::setSampleRate(double newSampleRate)
   if( newSampleRate > 0.0 )
     sampleRate = newSampleRate;
   sampleRateRec = 1.0 / sampleRate;
-  increment = tableLengthDbl*freq*sampleRateRec;
+  calculateIncrement();
 }
 
 void BlendOscillator::setWaveForm1(int newWaveForm1)
@@ -58,11 +67,53 @@ void BlendOscillator::setWaveForm2(int newWaveForm2)
 void BlendOscillator::setWaveTable1(MipMappedWaveTable* newWaveTable1)
 {
   waveTable1 = newWaveTable1;
+  updateIncrement();
 }
 
 void BlendOscillator::setWaveTable2(MipMappedWaveTable* newWaveTable2)
 {
   waveTable2 = newWaveTable2;
+  updateIncrement();
+}
+
+void BlendOscillator::setInterpolationMethod(int newMethod)
+{
+  if( newMethod >= 0 && newMethod < MipMappedWaveTable::NUM_INTERPOLATION_METHODS )
+    interpolation = newMethod;
+}
+
+void BlendOscillator::setBackend(int newBackend)
+{
+  if( newBackend >= 0 && newBackend < NUM_BACKENDS )
+    backend = newBackend;
+}
+
+void BlendOscillator::setSquareShape(double newDrive, double newOffset, double newShift)
+{
+  // The SQUARE303 table is -tanh(a*s+b) where s is the 303 saw shifted by newShift, i.e. 
+  // s = 2*u-1 with u in cycles since the saw's step. We use clip(a*s+b, -1, 1) instead of the tanh:
+  double a = dB2amp(newDrive);
+  double b = newOffset;
+  squareSlope = 2.0*a;
+  squareStart = b-a;
+  squareStep  = clip(b-a, -1.0, 1.0) - clip(b+a, -1.0, 1.0);
+
+  // the saw's step is half a cycle after the phase origin, the shift delays the whole waveform:
+  squarePhase = indexToPhase(tableLengthDbl * (0.5 - newShift/360.0));
+
+  // corners of the ramp (in u) where it reaches -1 and +1:
+  double u1 = (-1.0-squareStart) / squareSlope;
+  double u2 = (+1.0-squareStart) / squareSlope;
+  squareKink1   = (u1 > 0.0 && u1 < 1.0) ?  squareSlope : 0.0;
+  squareKink2   = (u2 > 0.0 && u2 < 1.0) ? -squareSlope : 0.0;
+  squareCorner1 = indexToPhase(tableLengthDbl * clip(u1, 0.0, 1.0));
+  squareCorner2 = indexToPhase(tableLengthDbl * clip(u2, 0.0, 1.0));
+
+  // mean value: -1 before the 1st corner, the ramp in between and +1 after the 2nd corner:
+  double c1 = clip(u1, 0.0, 1.0);
+  double c2 = clip(u2, 0.0, 1.0);
+  squareDC  = -c1 + (1.0-c2) 
+    + 0.5*squareSlope*(c2*c2-c1*c1) + squareStart*(c2-c1);
 }
 
 void BlendOscillator::setStartPhase(double StartPhase)
@@ -76,10 +127,25 @@ void BlendOscillator::setStartPhase(double StartPhase)
 
 void BlendOscillator::resetPhase()
 {
-  phaseIndex = startIndex;
+  phase      = indexToPhase(startIndex);
+  cycleCount = 0;
 }
 
 void BlendOscillator::setPhase(double PhaseIndex)
 {
-  phaseIndex = startIndex+PhaseIndex;
+  phase = indexToPhase(startIndex+PhaseIndex);
+}
+
+//-------------------------------------------------------------------------------------------------
+// internal functions:
+
+UINT64 BlendOscillator::indexToPhase(double index)
+{
+  double tableLengthDbl = (double) MipMappedWaveTable::tableLength;
+  index = fmod(index, tableLengthDbl);
+  if( index < 0.0 )
+    index += tableLengthDbl;
+  if( index >= tableLengthDbl ) // possible due to rounding in the addition above
+    index = 0.0;
+  return (UINT64) (index / fractionScale);
 }
@@ -3,6 +3,7 @@
 
 // rosic-indcludes:
 #include "rosic_MipMappedWaveTable.h"
+#include "tbrst_PolyBlep.h"
 
 namespace rosic
 {
@@ -20,6 +21,16 @@ namespace rosic
 
   public:
 
+    /** The ways of generating the waveforms. */
+    enum backends
+    {
+      WAVETABLE = 0, // read from the two mip-mapped wavetables
+      POLYBLEP,      // compute the 303 saw and square directly, band-limited by polynomial BLEPs 
+                     // and BLAMPs (ignores the tables)
+
+      NUM_BACKENDS
+    };
+
     //---------------------------------------------------------------------------------------------
     // construction/destruction:
 
@@ -65,7 +76,21 @@ namespace rosic
     INLINE void setPulseWidth(double newPulseWidth);
 
     /** Sets the phase increment from outside. */
-    INLINE void setIncrement(double newIncrement) { increment = newIncrement; }
+    INLINE void setIncrement(double newIncrement) { increment = newIncrement; updateIncrement(); }
+
+    /** Selects the interpolation method for reading the wavetables (one of 
+    MipMappedWaveTable::interpolationMethods). */
+    void setInterpolationMethod(int newMethod);
+
+    /** Selects how the waveforms are generated (one of the backends). */
+    void setBackend(int newBackend);
+
+    /** Sets up the tanh-shaped 303 square of the POLYBLEP backend - the parameters are the same as 
+    those of the SQUARE303 wavetable: drive in dB, raw offset and phase-shift in degrees. The 
+    tanh is approximated by a ramp with the same center slope which is clipped at +-1, so the 
+    square has an exact band-limited (BLAMP-corrected) counterpart. Cheap enough to be called per 
+    sample. */
+    void setSquareShape(double newDrive, double newOffset, double newShift);
 
     //---------------------------------------------------------------------------------------------
     // inquiry:
@@ -78,12 +103,33 @@ namespace rosic
     /** Returns the phase increment. */
     INLINE double getIncrement() const { return increment; }
 
+    /** Returns the phase increment in cycles per sample. */
+    INLINE double getCycleIncrement() const { return cycleIncrement; }
+
+    /** Returns the interpolation method for reading the wavetables. */
+    int getInterpolationMethod() const { return interpolation; }
+
+    /** Returns the backend which generates the waveforms. */
+    int getBackend() const { return backend; }
+
+    /** Returns the 1st wavetable. */
+    MipMappedWaveTable* getWaveTable1() const { return waveTable1; }
+
+    /** Returns the 2nd wavetable. */
+    MipMappedWaveTable* getWaveTable2() const { return waveTable2; }
+
     //---------------------------------------------------------------------------------------------
     // audio processing:
 
     /** Calculates one output sample at a time. */
     INLINE double getSample();
 
+    /** Returns a band-limited square wave 1 or 2 octaves (according to 'octaves') below the 
+    oscillator, derived from its phase - so it follows every change of the frequency exactly. It 
+    refers to the sample that the next call to getSample() will produce, so call it before 
+    getSample(). */
+    INLINE double getSubSample(int octaves);
+
     //---------------------------------------------------------------------------------------------
     // others:
 
@@ -101,14 +147,64 @@ namespace rosic
 
   protected:
 
+    /** Derives the fixed-point increment and the mip-level from 'increment' - called whenever the 
+    increment changes, so getSample doesn't have to do it for every sample. */
+    INLINE void updateIncrement();
+
+    /** Converts a (possibly out of range) phase index into the fixed-point phase format. */
+    static UINT64 indexToPhase(double index);
+
+    /** Converts a fixed-point phase into cycles (0...1). */
+    static INLINE double phaseToCycles(UINT64 p) 
+    { return (double) (INT64) (p >> indexBits) * fractionScale; }
+
+    /** Calculates one output sample with the POLYBLEP backend. */
+    INLINE double getSamplePolyBlep();
+
+    /** Advances the phase by one sample and counts the wraparounds. */
+    INLINE void advancePhase()
+    {
+      UINT64 newPhase = phase + phaseIncrement;
+      cycleCount += newPhase < phase; // wrapped around
+      phase       = newPhase;
+    }
+
+    // The phase is kept in 64 bit fixed-point format where the upper bits hold the integer table 
+    // index and the remaining (lower) bits the fractional part. Wraparound at the end of the table 
+    // is thereby just the natural integer overflow.
+    static const int    indexBits     = 11; // log2(tableLength)
+    static const int    fractionBits  = 64-indexBits;
+    static const UINT64 fractionMask  = (((UINT64) 1) << fractionBits) - 1;
+    static constexpr double fractionScale = 1.0 / (double) (((UINT64) 1) << fractionBits);
+    static_assert(MipMappedWaveTable::tableLength == 1 << indexBits, 
+      "indexBits must match the table length");
+
     double tableLengthDbl;    // tableLength as double variable
-    double phaseIndex;        // current phase index
+    UINT64 phase;             // current phase (fixed-point)
+    UINT64 phaseIncrement;    // phase increment per sample (fixed-point)
+    unsigned int cycleCount;  // number of completed cycles (modulo 2^32), for the sub-oscillator
+    int    tableNumber;       // mip-level for the current increment, -1 if a wavetable is missing
     double freq;              // frequency of the oscillator
     double increment;         // phase increment per sample
     double blend;             // the blend factor between the two waveforms
     double startIndex;        // start-phase-index of the osc (range: 0 - tableLength)
     double sampleRate;        // the samplerate
     double sampleRateRec;     // 1/sampleRate
+    int    interpolation;     // one of MipMappedWaveTable::interpolationMethods
+    int    backend;           // one of the backends
+
+    // POLYBLEP backend: the 303 square is the clipped ramp 
+    // clip(squareSlope*u + squareStart, -1, 1), with u in cycles since its wraparound step:
+    double cycleIncrement;    // increment in cycles
+    UINT64 squarePhase;       // offset of u with respect to the phase
+    double squareSlope;       // slope of the ramp per cycle
+    double squareStart;       // value of the ramp at u = 0
+    double squareStep;        // height of the step at u = 0
+    UINT64 squareCorner1;     // u where the ramp enters the range -1...+1 (as phase)
+    UINT64 squareCorner2;     // u where the ramp leaves the range -1...+1 (as phase)
+    double squareKink1;       // slope change at squareCorner1 per cycle (0 if there's no corner)
+    double squareKink2;       // slope change at squareCorner2 per cycle (0 if there's no corner)
+    double squareDC;          // mean value (the wavetables have no DC either)
 
     MipMappedWaveTable *waveTable1, *waveTable2; // the 2 wavetables between which we blend
 
@@ -132,39 +228,143 @@ namespace rosic
   INLINE void BlendOscillator::calculateIncrement()
   {
     increment = tableLengthDbl*freq*sampleRateRec;
+    updateIncrement();
   }
 
-  INLINE double BlendOscillator::getSample()
+  INLINE void BlendOscillator::updateIncrement()
   {
-    double out1, out2;
-    int    tableNumber;
+    cycleIncrement = increment / tableLengthDbl;
+    if( increment >= 0.0 && increment < tableLengthDbl )
+      phaseIncrement = (UINT64) (increment / fractionScale);
+    else
+      phaseIncrement = indexToPhase(increment);
 
     if( waveTable1 == NULL || waveTable2 == NULL )
-      return 0.0;
+    {
+      tableNumber = -1;
+      return;
+    }
 
     // from this increment, decide which table is to be used:
     tableNumber  = ((int)EXPOFDBL(increment));
     //tableNumber += 1;           // generate frequencies up to nyquist/2 on the highest note
     tableNumber += 2;             // generate frequencies up to nyquist/4 on the highest note
                                   // \todo: make this number adjustable from outside
+    if( tableNumber <= 0 )
+      tableNumber = 0;
+    else if( tableNumber >= MipMappedWaveTable::numTables )
+      tableNumber = MipMappedWaveTable::numTables-1;
+  }
+
+  INLINE double BlendOscillator::getSample()
+  {
+    double out1, out2;
+
+    if( backend == POLYBLEP )
+      return getSamplePolyBlep();
 
-    // wraparound if necessary:
-    while( phaseIndex>=tableLengthDbl )
-      phaseIndex -= tableLengthDbl;
+    if( tableNumber < 0 )
+      return 0.0;
 
-    int    intIndex = floorInt(phaseIndex);
-    double frac     = phaseIndex  - (double) intIndex;
-    out1 = (1.0-blend) * waveTable1->getValueLinear(intIndex, frac, tableNumber);
-    out2 =      blend  * waveTable2->getValueLinear(intIndex, frac, tableNumber);
+    int    intIndex = (int) (phase >> fractionBits);
+    double frac     = (double) (INT64) (phase & fractionMask) * fractionScale;
+#ifdef OPEN303_FLOAT_WAVETABLES
+    // read both waveforms from their interleaved single precision levels if the 2nd table has 
+    // them for our 1st one (otherwise fall back to the double tables below):
+    const MipMappedWaveTable::InterleavedLevel* levels = 
+      waveTable2->getInterleavedLevels(waveTable1);
+    if( levels != NULL )
+    {
+      const float* level = levels[tableNumber].samples;
+      if( interpolation == MipMappedWaveTable::LINEAR )
+      {
+        const float* tap = level + 2*intIndex;
+        out1 = (1.0-blend) * ((1.0-frac)*tap[0] + frac*tap[2]);
+        out2 =      blend  * ((1.0-frac)*tap[1] + frac*tap[3]);
+      }
+      else
+      {
+        double w[4];
+        MipMappedWaveTable::getCubicWeights(interpolation, frac, w);
+        const float* tap = level + 2*((intIndex-1) & (MipMappedWaveTable::tableLength-1));
+        out1 = (1.0-blend) * (w[0]*tap[0] + w[1]*tap[2] + w[2]*tap[4] + w[3]*tap[6]);
+        out2 =      blend  * (w[0]*tap[1] + w[1]*tap[3] + w[2]*tap[5] + w[3]*tap[7]);
+      }
+    }
+    else
+#endif
+    {
+      // tableNumber is already in range, so we may read the tables directly:
+      const double* table1 = waveTable1->tableSet[tableNumber];
+      const double* table2 = waveTable2->tableSet[tableNumber];
+      if( interpolation == MipMappedWaveTable::LINEAR )
+      {
+        out1 = (1.0-blend) * ((1.0-frac)*table1[intIndex] + frac*table1[intIndex+1]);
+        out2 =      blend  * ((1.0-frac)*table2[intIndex] + frac*table2[intIndex+1]);
+      }
+      else
+      {
+        // the weights are the same for both tables:
+        double w[4];
+        MipMappedWaveTable::getCubicWeights(interpolation, frac, w);
+        int i = (intIndex-1) & (MipMappedWaveTable::tableLength-1);
+        out1 = (1.0-blend) * (w[0]*table1[i] + w[1]*table1[i+1] + w[2]*table1[i+2] + w[3]*table1[i+3]);
+        out2 =      blend  * (w[0]*table2[i] + w[1]*table2[i+1] + w[2]*table2[i+2] + w[3]*table2[i+3]);
+      }
+    }
     
     out2 *= 0.5; // \todo: this is preliminary to scale the square in AciDevil we need to
                  // implement something more general here (like a kind of crest-compensation in 
                  // the wavetable-class)
 
-    phaseIndex += increment;
+    advancePhase(); // wraps around by overflow
     return out1 + out2;
   }
 
+  INLINE double BlendOscillator::getSamplePolyBlep()
+  {
+    double dt = cycleIncrement;
+
+    // 303 saw - rises from 0 to 1 in the 1st half of the cycle, steps down to -1 and rises back 
+    // to 0 in the 2nd half:
+    double u   = phaseToCycles(phase + (((UINT64) 1) << 63)); // cycles since the step
+    double saw = 2.0*u - 1.0 - polyBlep(u, dt);
+
+    // 303 square - the clipped ramp with its corners and step band-limited:
+    u = phaseToCycles(phase + squarePhase);
+    double sqr = clip(squareSlope*u + squareStart, -1.0, 1.0);
+    sqr += 0.5*squareStep * polyBlep(u, dt);
+    sqr += squareKink1*dt * polyBlamp(phaseToCycles(phase + squarePhase - squareCorner1), dt);
+    sqr += squareKink2*dt * polyBlamp(phaseToCycles(phase + squarePhase - squareCorner2), dt);
+    sqr  = -(sqr - squareDC);  // inverted, like the wavetable
+
+    advancePhase();
+    return (1.0-blend) * saw + 0.5 * blend * sqr;  // same scaling of the square as above
+  }
+
+  INLINE double BlendOscillator::getSubSample(int octaves)
+  {
+    double u = phaseToCycles(phase);
+    double r = polyBlep(u, cycleIncrement); // nonzero only within 1 sample of a wraparound
+
+    if( octaves <= 1 )
+    {
+      // flips at every wraparound - the step of height 2*s at the start of this cycle (u near 0) 
+      // or of height -2*s at its end (u near 1):
+      double s = (cycleCount & 1) ? -1.0 : 1.0;
+      return s + (u < 0.5 ? s : -s) * r;
+    }
+    else
+    {
+      // flips at every 2nd wraparound - at the start of even and the end of odd cycles:
+      double s = (cycleCount & 2) ? -1.0 : 1.0;
+      if( cycleCount & 1 )
+        return s - (u < 0.5 ? 0.0 : s) * r;
+      else
+        return s + (u < 0.5 ? s : 0.0) * r;
+    }
+  }
+
 } // end namespace rosic
 
 #endif // rosic_BlendOscillator_h
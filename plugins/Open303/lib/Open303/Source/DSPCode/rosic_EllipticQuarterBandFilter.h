@@ -5,6 +5,7 @@
 
 // rosic-indcludes:
 #include "GlobalDefinitions.h"
+#include "tbrst_DenormalGuard.h" // for ANTI_DENORMAL
 
 namespace rosic
 {
@@ -81,7 +82,7 @@ namespace rosic
 
     // calculate intermediate and output sample via direct form II - the parentheses facilitate 
     // out-of-order execution of the independent additions (for performance optimization):
-    double tmp =   (in + TINY)
+    double tmp =   ANTI_DENORMAL(in)
                  - ( (a01*w[0] + a02*w[1] ) + (a03*w[2]  + a04*w[3]   ) ) 
                  - ( (a05*w[4] + a06*w[5] ) + (a07*w[6]  + a08*w[7]   ) )
                  - ( (a09*w[8] + a10*w[9] ) + (a11*w[10] +  a12*w[11] ) );
@@ -1,6 +1,12 @@
 #include "rosic_MipMappedWaveTable.h"
+#ifdef OPEN303_PRECOMPUTED_TABLES
+#include "tbrst_PrecomputedWaveTables.h"
+#endif
 using namespace rosic;
 
+// all-zero table set used until something gets rendered (i.e. the SILENCE waveform):
+static const double silentTableSet[MipMappedWaveTable::numTables][MipMappedWaveTable::tableLength+4] = {};
+
 MipMappedWaveTable::MipMappedWaveTable()
 {
   // init member variables:
@@ -9,21 +15,29 @@ MipMappedWaveTable::MipMappedWaveTable()
   symmetry   = 0.5;
 
   // initialize internal 'back-panel' parameters
-  tanhShaperFactor = dB2amp(36.9);
-  tanhShaperOffset = 4.37;
-  squarePhaseShift = 180.0;
-
-  // set up the fourier-transformer:
-  fourierTransformer.setBlockSize(tableLength);
-
-  // initialize the buffers:
-  initPrototypeTable();
-  initTableSet();
+  tanhShaperFactor = dB2amp(defaultTanhShaperDrive);
+  tanhShaperOffset = defaultTanhShaperOffset;
+  squarePhaseShift = default303SquarePhaseShift;
+
+  // the tables and the rendering scratch are allocated on the first render:
+  tableSet         = silentTableSet;
+  renderedTableSet = NULL;
+  ownScratch       = NULL;
+#ifdef OPEN303_FLOAT_WAVETABLES
+  interleavePartner         = NULL;
+  interleavedFirstSet       = NULL;
+  interleavedLevels         = NULL;
+  renderedInterleavedLevels = NULL;
+#endif
 }
 
 MipMappedWaveTable::~MipMappedWaveTable()
 {
-
+  delete[] renderedTableSet;
+#ifdef OPEN303_FLOAT_WAVETABLES
+  delete[] renderedInterleavedLevels;
+#endif
+  delete ownScratch;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -31,19 +45,22 @@ MipMappedWaveTable::~MipMappedWaveTable()
 
 void MipMappedWaveTable::setWaveform(double* newWaveForm, int lengthInSamples)
 {
-  int i;
-  if( lengthInSamples == tableLength )
+  if( lengthInSamples != tableLength )
   {
-    // just copy the values into the internal buffer, when the length of the passed table and the
-    // internal table match:
-    for( i=0; i<tableLength; i++ )
-      prototypeTable[i] = newWaveForm[i];
+    // \todo: implement periodic sinc-interpolation - until then, we keep the current tables 
+    // instead of rendering from a stale prototype:
+    DEBUG_BREAK; // the waveform must have tableLength samples
+    return;
   }
-  else
-  {
-    // implement periodic sinc-interpolation here...
-  }
-  generateMipMap();
+
+  // just copy the values into the internal buffer, when the length of the passed table and the
+  // internal table match:
+  RenderScratch* scratch = getOwnScratch();
+  for(int i=0; i<tableLength; i++)
+    scratch->prototype[i] = newWaveForm[i];
+  allocateTableSet();
+  generateMipMap(renderedTableSet, *scratch);
+  useRenderedTables();
 }
 
 void MipMappedWaveTable::setWaveform(int newWaveform)
@@ -61,172 +78,260 @@ void MipMappedWaveTable::setSymmetry(double newSymmetry)
   renderWaveform();
 }
 
+void MipMappedWaveTable::setWaveformParameters(int newWaveform, double newSymmetry, 
+                                               double newDrive, double newOffset, double newShift,
+                                               RenderScratch* scratch)
+{
+  if( newWaveform >= 0 )
+    waveform = newWaveform;
+  symmetry         = newSymmetry;
+  tanhShaperFactor = dB2amp(newDrive);
+  tanhShaperOffset = newOffset;
+  squarePhaseShift = newShift;
+  renderWaveform(scratch);
+}
+
+#ifdef OPEN303_FLOAT_WAVETABLES
+void MipMappedWaveTable::setInterleavePartner(const MipMappedWaveTable* first)
+{
+  interleavePartner = first;
+  updateInterleavedLevels();
+}
+#endif
+
 //-------------------------------------------------------------------------------------------------
 // internal functions:
 
-void MipMappedWaveTable::initPrototypeTable()
+void MipMappedWaveTable::allocateTableSet()
 {
-  for(int i=0; i<(tableLength+4); i++)
-    prototypeTable[i] = 0.0;
+  if( renderedTableSet == NULL )
+    renderedTableSet = new double[numTables][tableLength+4];
 }
 
-void MipMappedWaveTable::initTableSet()
+MipMappedWaveTable::RenderScratch* MipMappedWaveTable::getOwnScratch()
 {
-  int t, i; // indices for table and position
-  for(t=0; t<numTables; t++)
-    for(i=0; i<tableLength+4; i++)
-      tableSet[t][i] = 0.0;
+  if( ownScratch == NULL )
+    ownScratch = new RenderScratch;
+  return ownScratch;
 }
 
-void MipMappedWaveTable::removeDC()
+void MipMappedWaveTable::removeDC(double* prototype)
 {
   // calculate DC-offset (= average value of the table):
   double dcOffset = 0.0;
   int i;
   for(i=0; i<tableLength; i++)
-    dcOffset += prototypeTable[i];
+    dcOffset += prototype[i];
   dcOffset = dcOffset / tableLength;
 
   // remove DC-Offset:
   for(i=0; i<tableLength; i++)
-    prototypeTable[i] -= dcOffset;
+    prototype[i] -= dcOffset;
 }
 
-void MipMappedWaveTable::normalize()
+void MipMappedWaveTable::normalize(double* prototype)
 {
   // find maximum:
   double max = 0.0;
   int    i;
   for(i=0; i<tableLength; i++)
-    if( fabs(prototypeTable[i]) > max)
-      max = fabs(prototypeTable[i]);
+    if( fabs(prototype[i]) > max)
+      max = fabs(prototype[i]);
 
   // normalize to amplitude 1.0:
   double scale = 1.0/max;
   for(i=0; i<tableLength; i++)
-    prototypeTable[i] *= scale;
+    prototype[i] *= scale;
 }
 
-void MipMappedWaveTable::reverseTime()
+void MipMappedWaveTable::reverseTime(double* prototype)
 {
   int    i;
   double tmpTable[tableLength+4];
 
   for(i=0; i<tableLength; i++)
-    tmpTable[i] = prototypeTable[tableLength-i-1];
+    tmpTable[i] = prototype[tableLength-i-1];
 
   for(i=0; i<tableLength; i++)
-    prototypeTable[i] = tmpTable[i];
+    prototype[i] = tmpTable[i];
 }
 
-void MipMappedWaveTable::renderWaveform()
+bool MipMappedWaveTable::usePrecomputedTables()
 {
-  switch( waveform )
+#ifdef OPEN303_PRECOMPUTED_TABLES
+  // the 303 waveforms don't depend on the symmetry parameter:
+  if( waveform == SAW303 )
+  {
+    tableSet = precomputedSaw303Tables;
+#ifdef OPEN303_FLOAT_WAVETABLES
+    updateInterleavedLevels();
+#endif
+    return true;
+  }
+  if( waveform == SQUARE303 
+    && tanhShaperFactor == dB2amp(defaultTanhShaperDrive)
+    && tanhShaperOffset == defaultTanhShaperOffset
+    && squarePhaseShift == default303SquarePhaseShift )
   {
-  case   SINE:      fillWithSine();        break;
-  case   TRIANGLE:  fillWithTriangle();    break;
-  case   SQUARE:    fillWithSquare();      break;
-  case   SAW:       fillWithSaw();         break;
-  case   SQUARE303: fillWithSquare303();   break;
-  case   SAW303:    fillWithSaw303();      break;
-
-  default :  fillWithSine();
+    tableSet = precomputedSquare303Tables;
+#ifdef OPEN303_FLOAT_WAVETABLES
+    updateInterleavedLevels();
+#endif
+    return true;
   }
+#endif
+  return false;
 }
 
-void MipMappedWaveTable::generateMipMap()
+void MipMappedWaveTable::useRenderedTables()
 {
-  static double spectrum[tableLength];
-  //static int    position, offset;
-  static int t, i; // indices for the table and position
+  tableSet = renderedTableSet;
+#ifdef OPEN303_FLOAT_WAVETABLES
+  updateInterleavedLevels();
+#endif
+}
 
-  //position = 0;             // begin of the 1st table (index 0)
-  //offset   = tableLength+4; // offset between tow tables, the 4 is the number
-  // of additional samples used for interpolation
+#ifdef OPEN303_FLOAT_WAVETABLES
+void MipMappedWaveTable::updateInterleavedLevels()
+{
+  if( interleavePartner == NULL )
+  {
+    interleavedFirstSet = NULL;
+    interleavedLevels   = NULL;
+    return;
+  }
+  interleavedFirstSet = interleavePartner->tableSet;
 
-  // copy the prototypeTable into the 1st table of the mipmap (this actually makes the
-  // prototypeTable redundant - room for optimization here):
-  t = 0;
-  for(i=0; i<tableLength; i++)
-    tableSet[0][i] = prototypeTable[i];
+#ifdef OPEN303_PRECOMPUTED_TABLES
+  // the default pair is rendered at build time:
+  if( interleavedFirstSet == precomputedSaw303Tables && tableSet == precomputedSquare303Tables )
+  {
+    interleavedLevels = precomputedSaw303Square303Levels;
+    return;
+  }
+#endif
 
-  // additional sample(s) for the interpolator:
-  tableSet[t][tableLength]   = tableSet[t][0];
-  tableSet[t][tableLength+1] = tableSet[t][1];
-  tableSet[t][tableLength+2] = tableSet[t][2];
-  tableSet[t][tableLength+3] = tableSet[t][3];
+  if( renderedInterleavedLevels == NULL )
+    renderedInterleavedLevels = new InterleavedLevel[numTables];
+  for(int t=0; t<numTables; t++)
+  {
+    float* level = renderedInterleavedLevels[t].samples;
+    for(int i=0; i<tableLength+4; i++)
+    {
+      level[2*i]   = (float) interleavedFirstSet[t][i];
+      level[2*i+1] = (float) tableSet[t][i];
+    }
+  }
+  interleavedLevels = renderedInterleavedLevels;
+}
+#endif
+
+void MipMappedWaveTable::renderWaveform(RenderScratch* scratch)
+{
+  if( usePrecomputedTables() )
+    return;
 
+  if( scratch == NULL )
+    scratch = getOwnScratch();
+
+  double* prototype = scratch->prototype;
+  switch( waveform )
+  {
+  case   SINE:      fillWithSine(prototype);        break;
+  case   TRIANGLE:  fillWithTriangle(prototype);    break;
+  case   SQUARE:    fillWithSquare(prototype);      break;
+  case   SAW:       fillWithSaw(prototype);         break;
+  case   SQUARE303: fillWithSquare303(prototype);   break;
+  case   SAW303:    fillWithSaw303(prototype);      break;
+
+  default :  fillWithSine(prototype);
+  }
+
+  allocateTableSet();
+  generateMipMap(renderedTableSet, *scratch);
+  useRenderedTables();
+}
+
+void MipMappedWaveTable::generateMipMap(double (*tables)[tableLength+4], RenderScratch& scratch)
+{
+  analyzePrototype(scratch);
+  for(int t=0; t<numTables; t++)
+    renderMipMapLevel(t, scratch, tables[t], scratch);
+}
+
+void MipMappedWaveTable::analyzePrototype(RenderScratch& scratch)
+{
   // get the spectrum from the prototype-table:
-  fourierTransformer.transformRealSignal(prototypeTable, spectrum);
+  scratch.fourierTransformer.transformRealSignal(scratch.prototype, scratch.spectrum);
 
   // ensure that DC and Nyquist are zero:
-  spectrum[0] = 0.0;
-  spectrum[1] = 0.0;
+  scratch.spectrum[0] = 0.0;
+  scratch.spectrum[1] = 0.0;
+}
 
-  // now, render the bandlimited versions by successively shrinking the
-  // spectrum by one octave and iFFT'ing this spectrum:
-  int lowBin, highBin;
-  for(t=1; t<numTables; t++)
+void MipMappedWaveTable::renderMipMapLevel(int level, const RenderScratch& source, double* table,
+                                           RenderScratch& scratch)
+{
+  int i;
+  if( level == 0 )
   {
-    lowBin  = (int) (tableLength / pow(2.0, t));   // the cutoff-bin
-    highBin = (int) (tableLength / pow(2.0, t-1)); // the bin up to which the
-    // spectrum is currently still nonzero
-
-    // zero out the bins above the cutoff-bin:
-    for(i=lowBin; i<highBin; i++)
-      spectrum[i] = 0.0;
-
-    // transform the truncated spectrum back to the time-domain and store it in
-    // the tableSet
-    fourierTransformer.transformSymmetricSpectrum(spectrum, tableSet[t]);
-
-    // additional sample(s) for the interpolator:
-    tableSet[t][tableLength]   = tableSet[t][0];
-    tableSet[t][tableLength+1] = tableSet[t][1];
-    tableSet[t][tableLength+2] = tableSet[t][2];
-    tableSet[t][tableLength+3] = tableSet[t][3];
+    // the 1st table of the mipmap is the prototypeTable itself:
+    for(i=0; i<tableLength; i++)
+      table[i] = source.prototype[i];
   }
+  else
+  {
+    // render the bandlimited version by shrinking the spectrum by 'level' octaves, i.e. zeroing 
+    // out the bins above the cutoff-bin, and iFFT'ing this spectrum:
+    int cutoffBin = tableLength >> level;
+    for(i=0; i<cutoffBin; i++)
+      scratch.levelSpectrum[i] = source.spectrum[i];
+    for(i=cutoffBin; i<tableLength; i++)
+      scratch.levelSpectrum[i] = 0.0;
+    scratch.fourierTransformer.transformSymmetricSpectrum(scratch.levelSpectrum, table);
+  }
+
+  // additional sample(s) for the interpolator:
+  table[tableLength]   = table[0];
+  table[tableLength+1] = table[1];
+  table[tableLength+2] = table[2];
+  table[tableLength+3] = table[3];
 }
 
 //-------------------------------------------------------------------------------------------------
 // fill the prototype-table with various standard waveforms:
 
-void MipMappedWaveTable::fillWithSine()
+void MipMappedWaveTable::fillWithSine(double* prototype) const
 {
   for (long i=0; i<tableLength; i++)
-    prototypeTable[i] = sin( (2.0*PI*i) / (double) (tableLength) );
-  generateMipMap();
+    prototype[i] = sin( (2.0*PI*i) / (double) (tableLength) );
 }
 
-void MipMappedWaveTable::fillWithTriangle()
+void MipMappedWaveTable::fillWithTriangle(double* prototype) const
 {
   int i;
   for (i=0; i<(tableLength/4); i++)
-    prototypeTable[i] = (double)(4*i) / (double)(tableLength);
+    prototype[i] = (double)(4*i) / (double)(tableLength);
 
   for (i=(tableLength/4); i<(3*tableLength/4); i++)
-    prototypeTable[i] = 2.0 - ((double)(4*i) / (double)(tableLength));
+    prototype[i] = 2.0 - ((double)(4*i) / (double)(tableLength));
 
   for (i=(3*tableLength/4); i<(tableLength); i++)
-    prototypeTable[i] = -4.0+ ((double)(4*i) / (double)(tableLength));
-
-  generateMipMap();
+    prototype[i] = -4.0+ ((double)(4*i) / (double)(tableLength));
 }
 
-void MipMappedWaveTable::fillWithSquare()
+void MipMappedWaveTable::fillWithSquare(double* prototype) const
 {
   int    N  = tableLength;
   double k  = symmetry;
   int    N1 = clip(roundToInt(k*(N-1)), 1, N-1);
   for(int n=0; n<N1; n++)
-    prototypeTable[n] = +1.0;
+    prototype[n] = +1.0;
   for(int n=N1; n<N; n++)
-    prototypeTable[n] = -1.0;
-
-  generateMipMap();
+    prototype[n] = -1.0;
 }
 
-void MipMappedWaveTable::fillWithSaw()
+void MipMappedWaveTable::fillWithSaw(double* prototype) const
 {
   int    N  = tableLength;
   double k  = symmetry;
@@ -235,14 +340,12 @@ void MipMappedWaveTable::fillWithSaw()
   double s1 = 1.0 / (N1-1);
   double s2 = 1.0 / N2;
   for(int n=0; n<N1; n++)
-    prototypeTable[n] = s1*n;
+    prototype[n] = s1*n;
   for(int n=N1; n<N; n++)
-    prototypeTable[n] = -1.0 + s2*(n-N1);
-
-  generateMipMap();
+    prototype[n] = -1.0 + s2*(n-N1);
 }
 
-void MipMappedWaveTable::fillWithSquare303()
+void MipMappedWaveTable::fillWithSquare303(double* prototype) const
 {
   // generate the saw-wave:
   int    N  = tableLength;
@@ -252,22 +355,20 @@ void MipMappedWaveTable::fillWithSquare303()
   double s1 = 1.0 / (N1-1);
   double s2 = 1.0 / N2;
   for(int n=0; n<N1; n++)
-    prototypeTable[n] = s1*n;
+    prototype[n] = s1*n;
   for(int n=N1; n<N; n++)
-    prototypeTable[n] = -1.0 + s2*(n-N1);
+    prototype[n] = -1.0 + s2*(n-N1);
 
   // switch polarity and apply tanh-shaping with dc-offset:
   for(int n=0; n<N; n++)
-    prototypeTable[n] = -tanh(tanhShaperFactor*prototypeTable[n] + tanhShaperOffset);
+    prototype[n] = -tanh(tanhShaperFactor*prototype[n] + tanhShaperOffset);
 
   // do a circular shift to phase-align with the saw-wave, when both waveforms are mixed:
   int nShift = roundToInt(N*squarePhaseShift/360.0);
-  circularShift(prototypeTable, N, nShift);
-
-  generateMipMap();
+  circularShift(prototype, N, nShift);
 }
 
-void MipMappedWaveTable::fillWithSaw303()
+void MipMappedWaveTable::fillWithSaw303(double* prototype) const
 {
   // generate the saw-wave:
   int    N  = tableLength;
@@ -277,64 +378,45 @@ void MipMappedWaveTable::fillWithSaw303()
   double s1 = 1.0 / (N1-1);
   double s2 = 1.0 / N2;
   for(int n=0; n<N1; n++)
-    prototypeTable[n] = s1*n;
+    prototype[n] = s1*n;
   for(int n=N1; n<N; n++)
-    prototypeTable[n] = -1.0 + s2*(n-N1);
+    prototype[n] = -1.0 + s2*(n-N1);
 
   // switch polarity:
   //for(int n=0; n<N; n++)
-  //  prototypeTable[n] = -prototypeTable[n];
-
-  generateMipMap();
+  //  prototype[n] = -prototype[n];
 }
 
-void MipMappedWaveTable::fillWithPeak()
+void MipMappedWaveTable::fillWithPeak(double* prototype) const
 {
   int i;
   for (i=0; i<(tableLength/2); i++)
-    prototypeTable[i] = 1 - (double)(2*i) / (double)(tableLength);
+    prototype[i] = 1 - (double)(2*i) / (double)(tableLength);
 
   for (i=(tableLength/2); i<(tableLength); i++)
-    prototypeTable[i] = 0.0;
-
-  removeDC();
-  normalize();
+    prototype[i] = 0.0;
 
-  generateMipMap();
+  removeDC(prototype);
+  normalize(prototype);
 }
 
-void MipMappedWaveTable::fillWithMoogSaw()
+void MipMappedWaveTable::fillWithMoogSaw(double* prototype) const
 {
   // the sawUp part:
   int i;
   for (i=0; i<(tableLength/2); i++)
-    prototypeTable[i] = (double)(2*i) / (double)(tableLength);
+    prototype[i] = (double)(2*i) / (double)(tableLength);
 
   for (i=(tableLength/2); i<(tableLength); i++)
-    prototypeTable[i] = (double)(2*i) / (double)(tableLength) - 2.0;
+    prototype[i] = (double)(2*i) / (double)(tableLength) - 2.0;
 
   // the triangle part:
   for (i=0; i<(tableLength/2); i++)
-    prototypeTable[i] += 1 - (double)(4*i) / (double)(tableLength);
+    prototype[i] += 1 - (double)(4*i) / (double)(tableLength);
 
   for (i=(tableLength/2); i<tableLength; i++)
-    prototypeTable[i] += -1 + (double)(4*i) / (double)(tableLength);
+    prototype[i] += -1 + (double)(4*i) / (double)(tableLength);
 
-  removeDC();
-  normalize();
-
-  generateMipMap();
+  removeDC(prototype);
+  normalize(prototype);
 }
-
-
-
-
-
-
-
-
-
-
-
-
-
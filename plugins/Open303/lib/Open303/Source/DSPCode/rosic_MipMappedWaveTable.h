@@ -27,6 +27,48 @@ namespace rosic
 
   public:
 
+    static const int tableLength = 2048;
+      // Length of the lookup-table. The actual length of the allocated memory is 4 samples longer, 
+      // to store additional samples for the interpolator (which are the same values as at the 
+      // beginning of the buffer) */
+
+    static const int numTables = 12;
+      // The Oscillator class uses a one table-per octave multisampling to avoid aliasing. With a 
+      // table-size of 8192 and a sample-sample rate of  44100, the 12th table will have a 
+      // fundamental frequency (the frequency where the increment is 1) of 11025 which is good for 
+      // the highest frequency. 
+
+    // default values for the internal 'back-panel' parameters of the 303-square:
+    static constexpr double defaultTanhShaperDrive  = 36.9;  // in dB
+    static constexpr double defaultTanhShaperOffset = 4.37;
+    static constexpr double default303SquarePhaseShift = 180.0; // in degrees
+
+    /** Scratch memory for rendering a mip-map. The rendering functions only write to the scratch 
+    and the target tables that are passed to them, so several tables (or several levels of one 
+    table) can be rendered concurrently, as long as each thread uses its own scratch object. 
+    Allocates the FFT work areas on construction - don't create these on the audio thread. */
+    class RenderScratch
+    {
+    public:
+      RenderScratch() { fourierTransformer.setBlockSize(tableLength); }
+
+      double prototype[tableLength+4];  // the full-bandwidth prototype waveform
+      double spectrum[tableLength];     // spectrum of the prototype (interleaved re/im)
+      double levelSpectrum[tableLength]; // band-limited copy of the spectrum for one mip-level
+      FourierTransformerRadix2 fourierTransformer;
+    };
+
+#ifdef OPEN303_FLOAT_WAVETABLES
+    /** One mip-level of two wavetables in single precision, interleaved per index: samples[2*i] 
+    is sample i of the 1st table and samples[2*i+1] that of the 2nd. Aligned to 64 bytes, so that 
+    the 4 values read for a linearly interpolated sample of both tables usually sit in a single 
+    cache line. */
+    struct alignas(64) InterleavedLevel
+    {
+      float samples[2*(tableLength+4)];
+    };
+#endif
+
     enum waveforms
     {
       SILENCE = 0,
@@ -38,6 +80,15 @@ namespace rosic
       SAW303
     };
 
+    enum interpolationMethods
+    {
+      LINEAR = 0,
+      HERMITE,   // 4-point, 3rd order Hermite (Catmull-Rom)
+      LAGRANGE,  // 4-point, 3rd order Lagrange
+
+      NUM_INTERPOLATION_METHODS
+    };
+
     //---------------------------------------------------------------------------------------------
     // construction/destruction:
 
@@ -58,7 +109,8 @@ namespace rosic
     /** Overloaded function to set the waveform from outside this class. This function expects a 
     pointer to the prototype-waveform to be handed over along with the length of this waveform. It 
     copies the values into the internal buffers and renders various bandlimited version via 
-    FFT/iFFT.
+    FFT/iFFT. The waveform must have tableLength samples - other lengths are rejected (the current 
+    tables stay as they are).
     \todo: Interpolation for the case that lengthInSamples does not match the length of the 
     internal table-length. */
     void setWaveform(double* newWaveform, int lengthInSamples);
@@ -73,21 +125,61 @@ namespace rosic
     /** Sets the drive (in dB) for the tanh-shaper for 303-square waveform - internal parameter, to 
     be scrapped eventually. */
     void setTanhShaperDriveFor303Square(double newDrive)
-    { tanhShaperFactor = dB2amp(newDrive); fillWithSquare303(); }
+    { tanhShaperFactor = dB2amp(newDrive); renderWaveform(); }
 
     /** Sets the offset (as raw value for the tanh-shaper for 303-square waveform - internal 
     parameter, to be scrapped eventually. */
     void setTanhShaperOffsetFor303Square(double newOffset)
-    { tanhShaperOffset = newOffset; fillWithSquare303(); }
+    { tanhShaperOffset = newOffset; renderWaveform(); }
 
     /** Sets the phase shift of tanh-shaped square wave with respect to the saw-wave (in degrees)
     - this is important when the two are mixed. */
     void set303SquarePhaseShift(double newShift)
-    { squarePhaseShift = newShift; fillWithSquare303(); }
+    { squarePhaseShift = newShift; renderWaveform(); }
+
+    /** Sets up the waveform, the symmetry and the 303-square shaper parameters in one go and 
+    renders the mip-map only once (instead of once per setter call). The drive is expected in dB, 
+    the phase-shift in degrees. If a scratch object is passed, rendering uses that instead of the 
+    object's own (which is allocated on first use). */
+    void setWaveformParameters(int newWaveform, double newSymmetry, double newDrive, 
+      double newOffset, double newShift, RenderScratch* scratch = NULL);
+
+#ifdef OPEN303_FLOAT_WAVETABLES
+    /** Makes this table keep its levels interleaved with those of 'first' (as 1st table, this one 
+    as 2nd) - see getInterleavedLevels. The interleaved copy is converted here and after each 
+    render of this table, so set the partner where rendering is allowed. 'first' must stay alive 
+    as long as it is set, NULL removes it. */
+    void setInterleavePartner(const MipMappedWaveTable* first);
+#endif
+
+    //---------------------------------------------------------------------------------------------
+    // mip-map rendering (re-entrant):
+
+    /** Renders the mip-map for the prototype waveform in scratch.prototype into 'tables' - this 
+    just runs analyzePrototype and renderMipMapLevel for all levels. */
+    static void generateMipMap(double (*tables)[tableLength+4], RenderScratch& scratch);
+
+    /** First stage of generateMipMap: computes the spectrum of scratch.prototype into 
+    scratch.spectrum with DC and Nyquist removed. */
+    static void analyzePrototype(RenderScratch& scratch);
+
+    /** Second stage of generateMipMap: renders mip-level 'level' into 'table' (of length 
+    tableLength+4) from source.prototype (level 0) or the band-limited source.spectrum (all other 
+    levels, where level n keeps the lower 1/2^n of the spectrum). The levels are independent of 
+    each other - 'source' is only read, so it may be shared by threads rendering different levels 
+    with their own 'scratch'. 'scratch' may be the same object as 'source'. */
+    static void renderMipMapLevel(int level, const RenderScratch& source, double* table, 
+      RenderScratch& scratch);
 
     //---------------------------------------------------------------------------------------------
     // inquiry:
 
+    /** Returns the index of the currently chosen built-in waveform. */
+    int getWaveform() const { return waveform; }
+
+    /** Returns the time symmetry between the first and second half-wave (as value between 0...1). */
+    double getSymmetry() const { return symmetry; }
+
     /** Returns the drive (in dB) for the tanh-shaper for 303-square waveform - internal parameter, to 
     be scrapped eventually. */
     double getTanhShaperDriveFor303Square() const { return amp2dB(tanhShaperFactor); }
@@ -100,6 +192,19 @@ namespace rosic
     - this is important when the two are mixed. */
     double get303SquarePhaseShift() const { return squarePhaseShift; }
 
+    /** Returns a pointer to the table with given index (0 is full bandwidth, each following one has
+    half of the bandwidth of its predecessor). The table has tableLength+4 entries. */
+    const double* getTable(int tableIndex) const { return tableSet[tableIndex]; }
+
+#ifdef OPEN303_FLOAT_WAVETABLES
+    /** Returns the levels of 'first' and this table interleaved, or NULL if 'first' doesn't hold 
+    the tables which the interleaved copy was made from. Tables with the same content built in at 
+    compile time count as the same, so all oscillators with default SAW303 tables can read the 
+    copies of shared SQUARE303 tables. */
+    const InterleavedLevel* getInterleavedLevels(const MipMappedWaveTable* first) const
+    { return first->tableSet == interleavedFirstSet ? interleavedLevels : NULL; }
+#endif
+
     //---------------------------------------------------------------------------------------------
     // audio processing:
 
@@ -114,74 +219,94 @@ namespace rosic
     internally. */
     INLINE double getValueLinear(double phaseIndex, int tableIndex);
 
-  protected:
-
-    // functions to fill table with the built-in waveforms (these functions are
-    // called from setWaveform(int newWaveform):
-    void fillWithSine();
-    void fillWithTriangle();
-    void fillWithSquare();
-    void fillWithSaw();
-    void fillWithSquare303();
-    void fillWithSaw303();
-    void fillWithPeak();
-    void fillWithMoogSaw();
+    /** Computes the weights of the 4 taps of a cubic interpolator (HERMITE or LAGRANGE) at 
+    fractional position 'frac' between the 2nd and 3rd tap. The weights depend only on the 
+    position, so they can be shared between several tables which are read at the same phase. */
+    static INLINE void getCubicWeights(int method, double frac, double* weights);
 
-    void initPrototypeTable();
-      // fills the "prototypeTable"-variable with all zeros
+    /** Returns the weighted sum of the 4 values at positions integerPart-1...integerPart+2 of 
+    table 'tableIndex' where the weights come from getCubicWeights. */
+    INLINE double getValueCubic(int integerPart, const double* weights, int tableIndex);
 
-    void initTableSet();
-      // fills the "tableSet"-variable with all zeros
+  protected:
 
-    void removeDC();
+    // functions to fill a prototype table (of length tableLength) with the built-in waveforms 
+    // (these functions are called from renderWaveform):
+    void fillWithSine(double* prototype) const;
+    void fillWithTriangle(double* prototype) const;
+    void fillWithSquare(double* prototype) const;
+    void fillWithSaw(double* prototype) const;
+    void fillWithSquare303(double* prototype) const;
+    void fillWithSaw303(double* prototype) const;
+    void fillWithPeak(double* prototype) const;
+    void fillWithMoogSaw(double* prototype) const;
+
+    void allocateTableSet();
+      // allocates the renderedTableSet (if not done yet)
+
+    static void removeDC(double* prototype);
       // removes dc-component from the waveform in the prototype-table
 
-    void normalize();
+    static void normalize(double* prototype);
       // normalizes the amplitude of the prototype-table to 1.0
 
-    void reverseTime();
+    static void reverseTime(double* prototype);
       // time-reverses the prototype-table
 
-    /** Renders the prototype waveform and generates the mip-map from that. */
-    void renderWaveform();
+    /** Renders the prototype waveform and generates the mip-map from that, using the passed 
+    scratch or (if NULL) our own. */
+    void renderWaveform(RenderScratch* scratch = NULL);
 
-    void generateMipMap();
-      // generates a multisample from the prototype table, where each of the
-      // successive tables contains one half of the spectrum of the previous one
+    /** Returns our own scratch object (allocated on the first call). */
+    RenderScratch* getOwnScratch();
 
-    static const int tableLength = 2048;
-      // Length of the lookup-table. The actual length of the allocated memory is 4 samples longer, 
-      // to store additional samples for the interpolator (which are the same values as at the 
-      // beginning of the buffer) */
+    /** Points tableSet to build-time rendered data if the current settings match the defaults
+    those were rendered with (only with OPEN303_PRECOMPUTED_TABLES). Returns true if it did. */
+    bool usePrecomputedTables();
 
+    /** Points tableSet to the freshly rendered renderedTableSet. */
+    void useRenderedTables();
 
-    double symmetry; // symmetry between 1st and 2nd half-wave
+#ifdef OPEN303_FLOAT_WAVETABLES
+    /** Points interleavedLevels to build-time rendered data for the current tables or converts 
+    them into renderedInterleavedLevels. */
+    void updateInterleavedLevels();
+#endif
 
-    static const int numTables = 12;
-      // The Oscillator class uses a one table-per octave multisampling to avoid aliasing. With a 
-      // table-size of 8192 and a sample-sample rate of  44100, the 12th table will have a 
-      // fundamental frequency (the frequency where the increment is 1) of 11025 which is good for 
-      // the highest frequency. 
+    double symmetry; // symmetry between 1st and 2nd half-wave
 
     int    waveform;   // index of the currently chosen native waveform
     double sampleRate; // the sampleRate
 
-    double prototypeTable[tableLength+4];
-      // this is the prototype-table with full bandwidth. one additional sample (same as 
-      // prototypeTable[0]) for linear interpolation without need for table wraparound at the last 
-      // sample (-> saves one if-statement each audio-cycle) ...and a three further addtional 
-      // samples for more elaborate interpolations like cubic (not implemented yet, also:
-      // the fillWith...()-functions don't support these samples yet). */
-
-    double tableSet[numTables][tableLength+4];
+    const double (*tableSet)[tableLength+4];
       // The multisample for anti-aliased waveform generation. The 4 additional values are equal 
       // to the first 4 values in the table for easier interpolation. The first index is for the 
       // table-number - index 0 accesses the first version which has full bandwidth, index 1 
       // accesses the second version which is bandlimited to Nyquist/2, 2->Nyquist/4, 
-      // 3->Nyquist/8, etc. */
+      // 3->Nyquist/8, etc. Points to renderedTableSet, to build-time rendered data or (as long as 
+      // nothing has been rendered) to an all-zero table set. */
+
+    double (*renderedTableSet)[tableLength+4];
+      // Our own storage for rendered tables - allocated on the first render, so that objects which
+      // only ever use precomputed tables are cheap to construct. */
 
-    // embedded objects:
-    FourierTransformerRadix2 fourierTransformer;
+    RenderScratch *ownScratch;
+      // Scratch for rendering on our own (prototype, spectrum and FFT) - allocated on the first 
+      // render that isn't given a scratch from outside. */
+
+#ifdef OPEN303_FLOAT_WAVETABLES
+    const MipMappedWaveTable *interleavePartner; // the 1st table of the interleaved copy
+
+    const double (*interleavedFirstSet)[tableLength+4];
+      // tableSet of the interleavePartner that interleavedLevels was made from
+
+    const InterleavedLevel *interleavedLevels;
+      // Our levels interleaved with those of the partner - points to renderedInterleavedLevels, to
+      // build-time rendered data or is NULL without partner. */
+
+    InterleavedLevel *renderedInterleavedLevels;
+      // Our own storage for the interleaved levels - allocated on the first conversion. */
+#endif
 
     // internal parameters:
     double tanhShaperFactor, tanhShaperOffset, squarePhaseShift;
@@ -222,6 +347,44 @@ namespace rosic
     //return (1.0-frac)*tableSet[tableIndex][intIndex] + frac*tableSet[tableIndex][intIndex+1];
   }
 
+  INLINE void MipMappedWaveTable::getCubicWeights(int method, double frac, double* weights)
+  {
+    double x = frac;
+    if( method == LAGRANGE )
+    {
+      // Lagrange polynomials through the nodes -1, 0, 1, 2:
+      double xp1 = x+1.0;
+      double xm1 = x-1.0;
+      double xm2 = x-2.0;
+      weights[0] = -(1.0/6.0) * x   * xm1 * xm2;
+      weights[1] =  0.5       * xp1 * xm1 * xm2;
+      weights[2] = -0.5       * xp1 * x   * xm2;
+      weights[3] =  (1.0/6.0) * xp1 * x   * xm1;
+    }
+    else
+    {
+      // Hermite with the slopes estimated by central differences (Catmull-Rom):
+      weights[0] = ((-0.5*x + 1.0)*x - 0.5)*x;
+      weights[1] = (1.5*x - 2.5)*x*x + 1.0;
+      weights[2] = ((-1.5*x + 2.0)*x + 0.5)*x;
+      weights[3] = (0.5*x - 0.5)*x*x;
+    }
+  }
+
+  INLINE double MipMappedWaveTable::getValueCubic(int integerPart, const double* weights, 
+    int tableIndex)
+  {
+    if( tableIndex<=0 )
+      tableIndex = 0;
+    else if ( tableIndex>=numTables )
+      tableIndex = numTables-1;
+
+    // the 1st tap is wrapped around to the end of the table for integerPart == 0 - the remaining 
+    // 3 then land in the additional samples:
+    const double* tap = &tableSet[tableIndex][(integerPart-1) & (tableLength-1)];
+    return weights[0]*tap[0] + weights[1]*tap[1] + weights[2]*tap[2] + weights[3]*tap[3];
+  }
+
 } // end namespace rosic
 
 #endif // rosic_MipMappedWaveTable_h
@@ -3,6 +3,7 @@
 
 // rosic-indcludes:
 #include "rosic_RealFunctions.h"
+#include "tbrst_DenormalGuard.h" // for ANTI_DENORMAL
 
 namespace rosic
 {
@@ -72,6 +73,10 @@ namespace rosic
     /** Returns the cutoff-frequency. */
     double getCutoff() const { return cutoff; }
 
+    /** Returns the filter coefficients (for y[n] = b0*x[n] + b1*x[n-1] + a1*y[n-1]). */
+    void getCoefficients(double *b0, double *b1, double *a1) const 
+    { *b0 = this->b0; *b1 = this->b1; *a1 = this->a1; }
+
     //---------------------------------------------------------------------------------------------
     // audio processing:
 
@@ -115,7 +120,7 @@ namespace rosic
   INLINE double OnePoleFilter::getSample(double in)
   {
     // calculate the output sample:
-    y1 = b0*in + b1*x1 + a1*y1 + TINY;
+    y1 = ANTI_DENORMAL(b0*in + b1*x1 + a1*y1);
 
     // update the buffer variables:
     x1 = in;
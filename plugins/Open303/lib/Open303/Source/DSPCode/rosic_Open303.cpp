@@ -7,73 +7,89 @@ using namespace rosic;
 Open303::Open303()
 {
   // Default parameter values
-  tuning           =   440.0;
-  ampScaler        =     1.0;
-  oscFreq          =   440.0;
-  sampleRate       = 44100.0;
-  level            =   -12.0;
-  levelByVel       =    12.0;
-  accent           =     0.0;
-  slideTime        =    60.0;
-  cutoff           =  1000.0;
-  envUpFraction    = 2.0/3.0;
-  normalAttack     =     3.0;
-  accentAttack     =     3.0;
-  normalDecay      =  1000.0;
-  accentDecay      =   200.0;
-  normalAmpRelease =     0.0;
-  accentAmpRelease =    50.0;
-  accentGain       =     0.0;
-  extInMix         =     0.0;
-  extInSample      =     0.0;
-  extInTrim        =     1.0; // Adjust as necessary to match oscillator and ext in levels
-  filterDrive      =     0.0;
-  pitchWheelFactor =     1.0;
-  currentNote      =      -1;
-  currentVel       =       0;
-  idle             =    true;
+  cold.tuning           =   440.0;
+  hot.ampScaler         =     1.0;
+  hot.oscFreq           =   440.0;
+  cold.sampleRate       = 44100.0;
+  cold.level            =   -12.0;
+  cold.levelByVel       =    12.0;
+  cold.accent           =     0.0;
+  cold.slideTime        =    60.0;
+  hot.cutoff            =  1000.0;
+  cold.envUpFraction    = 2.0/3.0;
+  cold.normalAttack     =     3.0;
+  cold.accentAttack     =     3.0;
+  cold.normalDecay      =  1000.0;
+  cold.accentDecay      =   200.0;
+  cold.normalAmpRelease =     0.0;
+  cold.accentAmpRelease =    50.0;
+  hot.accentGain        =     0.0;
+  cold.subOscLevel      =     0.0;
+  hot.subOscGain        =     0.0;
+  hot.subOscOctave      =     2;
+  hot.lastModExponent   =   NAN;
+  hot.modSubRate        =     1;
+  hot.modCounter        =     0;
+  hot.modAttackSamples  =     0;
+  hot.blockLength       =     0;
+  hot.noiseMix          =     0.0;
+  hot.filterFm          =     0.0;
+  hot.extInMix          =     0.0;
+  hot.extInSample       =     0.0;
+  hot.extInTrim         =     1.0; // Adjust as necessary to match oscillator and ext in levels
+  cold.filterDrive      =     0.0;
+  hot.driveAtBaseRate   =   false;
+  hot.pitchWheelFactor  =     1.0;
+  cold.currentNote      =      -1;
+  cold.currentVel       =       0;
+  hot.idle              =    true;
 
   setEnvMod(25.0);
 
-  oscillator.setWaveTable1(&waveTable1);
-  oscillator.setWaveForm1(MipMappedWaveTable::SAW303);
-  oscillator.setWaveTable2(&waveTable2);
-  oscillator.setWaveForm2(MipMappedWaveTable::SQUARE303);
+  hot.oscillator.setWaveTable1(&hot.waveTable1);
+  hot.oscillator.setWaveForm1(MipMappedWaveTable::SAW303);
+  hot.oscillator.setWaveTable2(&hot.waveTable2);
+  hot.oscillator.setWaveForm2(MipMappedWaveTable::SQUARE303);
+#ifdef OPEN303_FLOAT_WAVETABLES
+  hot.waveTable2.setInterleavePartner(&hot.waveTable1);
+#endif
+  updateSquareShape();
 
   //mainEnv.setNormalizeSum(true);
-  mainEnv.setNormalizeSum(false);
+  hot.mainEnv.setNormalizeSum(false);
 
-  ampEnv.setAttack(0.0);
-  ampEnv.setDecay(1230.0);
-  ampEnv.setSustainLevel(0.0);
-  ampEnv.setRelease(0.5);
-  ampEnv.setTauScale(1.0);
+  hot.ampEnv.setAttack(0.0);
+  hot.ampEnv.setDecay(1230.0);
+  hot.ampEnv.setSustainLevel(0.0);
+  hot.ampEnv.setRelease(0.5);
+  hot.ampEnv.setTauScale(1.0);
 
-  pitchSlewLimiter.setTimeConstant(60.0);
+  hot.pitchSlewLimiter.setTimeConstant(60.0);
   //ampDeClicker.setTimeConstant(2.0);
-  ampDeClicker.setMode(BiquadFilter::LOWPASS12);
-  ampDeClicker.setGain( amp2dB(sqrt(0.5)) );
-  ampDeClicker.setFrequency(200.0);
+  cold.ampDeClicker.setMode(BiquadFilter::LOWPASS12);
+  cold.ampDeClicker.setGain( amp2dB(sqrt(0.5)) );
+  cold.ampDeClicker.setFrequency(200.0);
 
-  rc1.setTimeConstant(0.0);
-  rc2.setTimeConstant(15.0);
+  hot.rc1.setTimeConstant(0.0);
+  hot.rc2.setTimeConstant(15.0);
 
-  highpass1.setMode(OnePoleFilter::HIGHPASS);
-  highpass2.setMode(OnePoleFilter::HIGHPASS);
-  allpass.setMode(OnePoleFilter::ALLPASS);
-  notch.setMode(BiquadFilter::BANDREJECT);
+  hot.highpass1.setMode(OnePoleFilter::HIGHPASS);
+  cold.highpass2.setMode(OnePoleFilter::HIGHPASS);
+  cold.allpass.setMode(OnePoleFilter::ALLPASS);
+  cold.notch.setMode(BiquadFilter::BANDREJECT);
 
-  setSampleRate(sampleRate);
+  setSampleRate(cold.sampleRate);
 
   // tweakables:
-  oscillator.setPulseWidth(50.0);
-  highpass1.setCutoff(44.486);
-  highpass2.setCutoff(24.167);
-  allpass.setCutoff(14.008);
-  notch.setFrequency(7.5164);
-  notch.setBandwidth(4.7);
-
-  filter.setFeedbackHighpassCutoff(150.0);
+  hot.oscillator.setPulseWidth(50.0);
+  hot.highpass1.setCutoff(44.486);
+  cold.highpass2.setCutoff(24.167);
+  cold.allpass.setCutoff(14.008);
+  cold.notch.setFrequency(7.5164);
+  cold.notch.setBandwidth(4.7);
+  updatePostFilters();
+
+  hot.filter.setFeedbackHighpassCutoff(150.0);
 }
 
 Open303::~Open303()
@@ -86,65 +102,104 @@ Open303::~Open303()
 
 void Open303::setSampleRate(double newSampleRate)
 {
-  mainEnv.setSampleRate         (       newSampleRate);
-  ampEnv.setSampleRate          (       newSampleRate);
-  pitchSlewLimiter.setSampleRate((float)newSampleRate);
-  ampDeClicker.setSampleRate(    (float)newSampleRate);
-  rc1.setSampleRate(             (float)newSampleRate);
-  rc2.setSampleRate(             (float)newSampleRate);
+  cold.sampleRate = newSampleRate;
+
+  hot.mainEnv.setSampleRate         (       newSampleRate);
+  hot.ampEnv.setSampleRate          (       newSampleRate);
+  hot.pitchSlewLimiter.setSampleRate((float)newSampleRate);
+  cold.ampDeClicker.setSampleRate(   (float)newSampleRate);
+  hot.rc1.setSampleRate(             (float)newSampleRate);
+  hot.rc2.setSampleRate(             (float)newSampleRate);
   //sequencer.setSampleRate(              newSampleRate);
 
-  highpass2.setSampleRate     (         newSampleRate);
-  allpass.setSampleRate       (         newSampleRate);
-  notch.setSampleRate         (         newSampleRate);
+  cold.highpass2.setSampleRate    (         newSampleRate);
+  cold.allpass.setSampleRate      (         newSampleRate);
+  cold.notch.setSampleRate        (         newSampleRate);
 
-  highpass1.setSampleRate     (  oversampling*newSampleRate);
+  updatePostFilters();
 
-  oscillator.setSampleRate    (  oversampling*newSampleRate);
-  filter.setSampleRate        (  oversampling*newSampleRate);
+  hot.highpass1.setSampleRate     (  oversampling*newSampleRate);
+
+  hot.oscillator.setSampleRate    (  oversampling*newSampleRate);
+  hot.filter.setSampleRate        (  oversampling*newSampleRate);
+  if( hot.driveAtBaseRate )
+    hot.driveStage.setSampleRate  (         newSampleRate);
+  else
+    hot.driveStage.setSampleRate  (  oversampling*newSampleRate);
+}
+
+void Open303::setDriveAtBaseRate(bool shouldRunAtBaseRate)
+{
+  if( shouldRunAtBaseRate == hot.driveAtBaseRate )
+    return;
+  hot.driveAtBaseRate = shouldRunAtBaseRate;
+  setSampleRate(cold.sampleRate);
+  hot.driveStage.reset();
+}
+
+void Open303::setModulationSubRate(int newSubRate)
+{
+  if( newSubRate < 1 || newSubRate > 16 || newSubRate == hot.modSubRate )
+    return;
+  hot.modSubRate      = newSubRate;
+  hot.modCounter       = 0;
+  hot.modAttackSamples = 0;
+  hot.lastModExponent  = NAN;
+}
+
+void Open303::updatePostFilters()
+{
+  double b0, b1, b2, a1, a2, b0A, b1A, a1A;
+  cold.allpass.getCoefficients(&b0A, &b1A, &a1A);
+  cold.highpass2.getCoefficients(&b0, &b1, &a1);
+  hot.postFilters.setSection(PostFilterChain::ALLPASS_HIGHPASS, b0A, b1A, a1A, b0, b1, a1);
+  cold.notch.getCoefficients(&b0, &b1, &b2, &a1, &a2);
+  hot.postFilters.setSection(PostFilterChain::NOTCH, b0, b1, b2, a1, a2);
+  cold.ampDeClicker.getCoefficients(&b0, &b1, &b2, &a1, &a2);
+  hot.postFilters.setSection(PostFilterChain::DECLICKER, b0, b1, b2, a1, a2);
 }
 
 void Open303::setCutoff(double newCutoff)
 {
-  cutoff = newCutoff;
+  hot.cutoff = newCutoff;
   calculateEnvModScalerAndOffset();
 }
 
 void Open303::setEnvMod(double newEnvMod)
 {
-  envMod = newEnvMod;
+  cold.envMod = newEnvMod;
   calculateEnvModScalerAndOffset();
 }
 
 void Open303::setAccent(double newAccent)
 {
-  accent = 0.01 * newAccent;
+  cold.accent = 0.01 * newAccent;
 }
 
 void Open303::setVolume(double newLevel)
 {
-  level     = newLevel;
-  ampScaler = dB2amp(level);
+  cold.level     = newLevel;
+  hot.ampScaler = dB2amp(cold.level);
 }
 
 void Open303::setFilterDrive(double newFilterDrive)
 {
-  filterDrive = newFilterDrive;
-  filter.setDrive(filterDrive);
+  cold.filterDrive = newFilterDrive;
+  hot.filter.setDrive(cold.filterDrive);
 }
 
 void Open303::setSlideTime(double newSlideTime)
 {
   if( newSlideTime >= 0.0 )
   {
-    slideTime = newSlideTime;
-    pitchSlewLimiter.setTimeConstant((float)(0.2*slideTime));  // \todo: tweak the scaling constant
+    cold.slideTime = newSlideTime;
+    hot.pitchSlewLimiter.setTimeConstant((float)(0.2*cold.slideTime));  // \todo: tweak the scaling constant
   }
 }
 
 void Open303::setPitchBend(double newPitchBend)
 {
-  pitchWheelFactor = pitchOffsetToFreqFactor(newPitchBend);
+  hot.pitchWheelFactor = pitchOffsetToFreqFactor(newPitchBend);
 }
 
 //------------------------------------------------------------------------------------------------------------
@@ -155,16 +210,16 @@ void Open303::noteOn(int noteNumber, int velocity, double detune)
   if( velocity == 0 ) // velocity zero indicates note-off events
   {
     MidiNoteEvent releasedNote(noteNumber, 0);
-    noteList.remove(releasedNote);
-    if( noteList.empty() )
+    cold.noteList.remove(releasedNote);
+    if( cold.noteList.empty() )
     {
-      currentNote = -1;
-      currentVel  = 0;
+      cold.currentNote = -1;
+      cold.currentVel  = 0;
     }
     else
     {
-      currentNote = noteList.front().getKey();
-      currentVel  = noteList.front().getVelocity();
+      cold.currentNote = cold.noteList.front().getKey();
+      cold.currentVel  = cold.noteList.front().getVelocity();
     }
     releaseNote(noteNumber);
   }
@@ -172,81 +227,108 @@ void Open303::noteOn(int noteNumber, int velocity, double detune)
   {
     // check if the note-list is empty (indicating that currently no note is playing) - if so,
     // trigger a new note, otherwise, slide to the new note:
-    if( noteList.empty() )
+    if( cold.noteList.empty() )
       triggerNote(noteNumber, velocity >= 100);
     else
       slideToNote(noteNumber, velocity >= 100);
 
-    currentNote = noteNumber;
-    currentVel  = 64;
+    cold.currentNote = noteNumber;
+    cold.currentVel  = 64;
 
     // and we need to add the new note to our list, of course:
     MidiNoteEvent newNote(noteNumber, velocity);
-    noteList.push_front(newNote);
+    cold.noteList.push_front(newNote);
   }
-  idle = false;
+  hot.idle = false;
 }
 
 void Open303::allNotesOff()
 {
-  noteList.clear();
-  ampEnv.noteOff();
-  currentNote = -1;
-  currentVel  = 0;
+  cold.noteList.clear();
+  hot.ampEnv.noteOff();
+  cold.currentNote      = -1;
+  cold.currentVel       = 0;
+}
+
+void Open303::reset()
+{
+  allNotesOff();
+  hot.ampEnv.reset();
+  hot.rc1.reset();
+  hot.rc2.reset();
+  hot.pitchSlewLimiter.reset();
+  hot.extInUpsampler.reset();
+
+  hot.accentGain       = 0.0;
+  hot.extInMix         = 0.0;
+  hot.extInSample      = 0.0;
+  hot.lastModExponent  = NAN;
+  hot.modCounter       = 0;
+  hot.modAttackSamples = 0;
+  hot.blockLength      = 0;
+  hot.idle             = true;
 }
 
 void Open303::triggerNote(int noteNumber, bool hasAccent)
 {
   // retrigger osc and reset filter buffers only if amplitude is near zero (to avoid clicks):
-  if( idle )
+  if( hot.idle )
   {
-    oscillator.resetPhase();
-    filter.reset();
-    highpass1.reset();
-    highpass2.reset();
-    allpass.reset();
-    notch.reset();
-    antiAliasFilter.reset();
-    ampDeClicker.reset();
+    hot.oscillator.resetPhase();
+    hot.filter.reset();
+    hot.highpass1.reset();
+    hot.postFilters.reset();
+    hot.antiAliasFilter.reset();
+    hot.noise.reset();
+    hot.driveStage.reset();
   }
 
   if( hasAccent )
   {
-    accentGain = accent;
-    setMainEnvDecay(accentDecay);
-    ampEnv.setRelease(accentAmpRelease);
+    hot.accentGain = cold.accent;
+    setMainEnvDecay(cold.accentDecay);
+    hot.ampEnv.setRelease(cold.accentAmpRelease);
   }
   else
   {
-    accentGain = 0.0;
-    setMainEnvDecay(normalDecay);
-    ampEnv.setRelease(normalAmpRelease);
+    hot.accentGain = 0.0;
+    setMainEnvDecay(cold.normalDecay);
+    hot.ampEnv.setRelease(cold.normalAmpRelease);
   }
 
-  oscFreq = pitchToFreq(noteNumber, tuning);
-  pitchSlewLimiter.setState(oscFreq);
-  mainEnv.trigger();
-  ampEnv.noteOn(true, noteNumber, 64);
-  idle = false;
+  hot.oscFreq = pitchToFreq(noteNumber, cold.tuning);
+  hot.pitchSlewLimiter.setState(hot.oscFreq);
+  hot.mainEnv.trigger();
+  hot.modCounter      = 0;    // let the cutoff follow the envelope from the start
+  hot.lastModExponent = NAN;  // without extrapolating from before the note
+
+  // update the cutoff for every sample during the attack (the time constant of the RC that 
+  // smoothes the envelope), up to the next point at the sub-rate:
+  double attackTime    = hasAccent ? rmax(hot.rc1.getTimeConstant(), hot.rc2.getTimeConstant()) 
+                                   : hot.rc1.getTimeConstant();
+  double attackSamples = 0.001 * attackTime * cold.sampleRate;
+  hot.modAttackSamples = hot.modSubRate * (int) ceil(attackSamples / hot.modSubRate);
+  hot.ampEnv.noteOn(true, noteNumber, 64);
+  hot.idle = false;
 }
 
 void Open303::slideToNote(int noteNumber, bool hasAccent)
 {
-  oscFreq = pitchToFreq(noteNumber, tuning);
+  hot.oscFreq = pitchToFreq(noteNumber, cold.tuning);
 
   if( hasAccent )
   {
-    accentGain = accent;
-    setMainEnvDecay(accentDecay);
-    ampEnv.setRelease(accentAmpRelease);
+    hot.accentGain = cold.accent;
+    setMainEnvDecay(cold.accentDecay);
+    hot.ampEnv.setRelease(cold.accentAmpRelease);
   }
   else
   {
-    accentGain = 0.0;
-    setMainEnvDecay(normalDecay);
-    ampEnv.setRelease(normalAmpRelease);
+    hot.accentGain = 0.0;
+    setMainEnvDecay(cold.normalDecay);
+    hot.ampEnv.setRelease(cold.normalAmpRelease);
   }
-  idle = false;
+  hot.idle = false;
 }
 
 void Open303::releaseNote(int noteNumber)
@@ -254,21 +336,21 @@ void Open303::releaseNote(int noteNumber)
   // check if the note-list is empty now. if so, trigger a release, otherwise slide to the note
   // at the beginning of the list (this is the most recent one which is still in the list). this
   // initiates a slide back to the most recent note that is still being held:
-  if( noteList.empty() )
+  if( cold.noteList.empty() )
   {
     //filterEnvelope.noteOff();
-    ampEnv.noteOff();
+    hot.ampEnv.noteOff();
   }
   else
   {
     // initiate slide back:
-    oscFreq = pitchToFreq(currentNote);
+    hot.oscFreq = pitchToFreq(cold.currentNote);
   }
 }
 
 void Open303::setMainEnvDecay(double newDecay)
 {
-  mainEnv.setDecayTimeConstant(newDecay);
+  hot.mainEnv.setDecayTimeConstant(newDecay);
   updateNormalizer1();
   updateNormalizer2();
 }
@@ -289,35 +371,42 @@ void Open303::calculateEnvModScalerAndOffset()
     const double sHiC = 0.864344900642434;       // constant in line eq. for scaler at high cutoff
 
     // do the calculation of the scaler and offset:
-    double e   = linToLin(envMod, 0.0, 100.0, 0.0, 1.0);
-    double c   = expToLin(cutoff, c0,   c1,   0.0, 1.0);
+    double e   = linToLin(cold.envMod, 0.0, 100.0, 0.0, 1.0);
+    double c   = expToLin(hot.cutoff, c0,   c1,   0.0, 1.0);
     double sLo = sLoF*e + sLoC;
     double sHi = sHiF*e + sHiC;
-    envScaler  = (1-c)*sLo + c*sHi;
-    envOffset  =  oF*c + oC;
+    hot.envScaler  = (1-c)*sLo + c*sHi;
+    hot.envOffset  =  oF*c + oC;
   }
   else
   {
-    double upRatio   = pitchOffsetToFreqFactor(      envUpFraction *envMod);
-    double downRatio = pitchOffsetToFreqFactor(-(1.0-envUpFraction)*envMod);
-    envScaler        = upRatio - downRatio;
-    if( envScaler != 0.0 ) // avoid division by zero
-      envOffset = - (downRatio - 1.0) / (upRatio - downRatio);
+    double upRatio   = pitchOffsetToFreqFactor(      cold.envUpFraction *cold.envMod);
+    double downRatio = pitchOffsetToFreqFactor(-(1.0-cold.envUpFraction)*cold.envMod);
+    hot.envScaler        = upRatio - downRatio;
+    if( hot.envScaler != 0.0 ) // avoid division by zero
+      hot.envOffset = - (downRatio - 1.0) / (upRatio - downRatio);
     else
-      envOffset = 0.0;
+      hot.envOffset = 0.0;
   }
 }
 
 void Open303::updateNormalizer1()
 {
-  n1 = LeakyIntegrator::getNormalizer(mainEnv.getDecayTimeConstant(), rc1.getTimeConstant(),
-    sampleRate);
-  n1 = 1.0; // test
+  hot.n1 = LeakyIntegrator::getNormalizer(hot.mainEnv.getDecayTimeConstant(), 
+    hot.rc1.getTimeConstant(), cold.sampleRate);
+  hot.n1 = 1.0; // test
 }
 
 void Open303::updateNormalizer2()
 {
-  n2 = LeakyIntegrator::getNormalizer(mainEnv.getDecayTimeConstant(), rc2.getTimeConstant(),
-    sampleRate);
-  n2 = 1.0; // test
+  hot.n2 = LeakyIntegrator::getNormalizer(hot.mainEnv.getDecayTimeConstant(), 
+    hot.rc2.getTimeConstant(), cold.sampleRate);
+  hot.n2 = 1.0; // test
+}
+
+void Open303::updateSquareShape()
+{
+  const MipMappedWaveTable* squareTable = hot.oscillator.getWaveTable2();
+  hot.oscillator.setSquareShape(squareTable->getTanhShaperDriveFor303Square(), 
+    squareTable->getTanhShaperOffsetFor303Square(), squareTable->get303SquarePhaseShift());
 }
@@ -10,6 +10,10 @@
 #include "rosic_DecayEnvelope.h"
 #include "rosic_LeakyIntegrator.h"
 #include "rosic_EllipticQuarterBandFilter.h"
+#include "tbrst_NoiseGenerator.h"
+#include "tbrst_DriveStage.h"
+#include "tbrst_PostFilterChain.h"
+#include "tbrst_PolyphaseUpsampler.h"
 #include "GlobalDefinitions.h"  // for linearBlend()
 
 #include <list>
@@ -47,19 +51,53 @@ namespace rosic
 
     /** Sets up the waveform continuously between saw and square - the input should be in the range 
     0...1 where 0 means pure saw and 1 means pure square. */
-    void setWaveform(double newWaveform) { oscillator.setBlendFactor(newWaveform); }
+    void setWaveform(double newWaveform) { hot.oscillator.setBlendFactor(newWaveform); }
+
+    /** Selects how the oscillator interpolates its wavetables (one of 
+    MipMappedWaveTable::interpolationMethods) - the cubic methods cost a bit more per sample but 
+    have much less interpolation error than LINEAR. */
+    void setOscillatorInterpolation(int newMethod) { hot.oscillator.setInterpolationMethod(newMethod); }
+
+    /** Selects how the oscillator generates its waveforms (one of BlendOscillator::backends). */
+    void setOscillatorBackend(int newBackend) { hot.oscillator.setBackend(newBackend); }
 
     /** Sets the master tuning frequency for note A4 (usually 440 Hz). */
-    void setTuning(double newTuning) { tuning = newTuning; }
+    void setTuning(double newTuning) { cold.tuning = newTuning; }
 
     /** Sets the filter's nominal cutoff frequency (in Hz). */
     void setCutoff(double newCutoff); 
 
-    /** Sets the resonance amount for the filter. */
-    void setResonance(double newResonance) { filter.setResonance(newResonance); }
+    /** Sets the resonance amount for the filter. The coefficients are updated along with the 
+    cutoff in the next call to getSample. */
+    void setResonance(double newResonance) { hot.filter.setResonance(newResonance, false); }
+
+    /** Sets the number of samples between updates of the envelope-driven filter cutoff (1...16, 
+    typically 1, 4, 8 or 16). Above 1, the filter coefficients are calculated only at these points
+    and interpolated linearly in between, which saves most of the cost of the cutoff modulation 
+    but delays it by up to that many samples. During the attack of the filter envelope (for the 
+    time constant of its attack after a note is triggered), the coefficients are still calculated
+    for every sample, because the envelope moves too fast there to be interpolated. */
+    void setModulationSubRate(int newSubRate);
 
     /** Filter morph (low/band/high-pass) */
-    void setFilterMorph(double newFilterMorphPosition) { filter.setFilterMorph(newFilterMorphPosition); }
+    void setFilterMorph(double newFilterMorphPosition) { hot.filter.setFilterMorph(newFilterMorphPosition); }
+
+    /** Selects the solution of the 303 ladder: the standard one, the zero-delay feedback one 
+    (which keeps tuning and resonance independent of the oversampling factor) or the nonlinear one 
+    (which saturates inside the ladder). @see TeeBeeFilterMorph::ladders */
+    void setFilterLadder(int newLadder) { hot.filter.setLadder(newLadder); }
+
+    /** Sets the depth of the cutoff modulation by the oscillator, in octaves per unit of 
+    oscillator amplitude. The modulation runs at the oversampled rate, with the filter 
+    coefficients fitted around the cutoff (@see TeeBeeFilter::setCutoffFmDepth), and takes effect
+    at the next update of the envelope-driven cutoff (@see setModulationSubRate). The depth is 
+    clipped to +-2 octaves - beyond that, the fitted coefficients drift too far from the exact 
+    ones. */
+    void setFilterFm(double newDepth) 
+    { 
+      hot.filterFm = clip(newDepth, -2.0, 2.0); 
+      hot.filter.setCutoffFmDepth(hot.filterFm); 
+    }
 
     /** Sets the modulation depth of the filter's cutoff frequency by the filter-envelope generator 
     (in percent). */
@@ -68,7 +106,7 @@ namespace rosic
     /** Sets the main envelope's decay time for non-accented notes (in milliseconds). 
     Devil Fish provides range of 30...3000 ms for this parameter. On the normal 303, this 
     parameter had a range of 200...2000 ms.  */
-    void setDecay(double newDecay) { normalDecay = newDecay; }
+    void setDecay(double newDecay) { cold.normalDecay = newDecay; }
 
     /** Sets the accent (in percent).  */
     void setAccent(double newAccent);
@@ -84,30 +122,42 @@ namespace rosic
     /** Sets the amplitudes envelope's sustain level in decibels. Devil Fish uses the second half 
     of the range of the (amplitude) decay pot for this and lets the user adjust it between 0 
     and 100% of the full volume. In the normal 303, this parameter was fixed to zero. */
-    void setAmpSustain(double newAmpSustain) { ampEnv.setSustainInDecibels(newAmpSustain); }
+    void setAmpSustain(double newAmpSustain) { hot.ampEnv.setSustainInDecibels(newAmpSustain); }
 
     /** Sets the drive (in dB) for the tanh-shaper for 303-square waveform - internal parameter, to 
     be scrapped eventually. */
     void setTanhShaperDrive(double newDrive) 
-    { waveTable2.setTanhShaperDriveFor303Square(newDrive); }
+    { hot.waveTable2.setTanhShaperDriveFor303Square(newDrive); updateSquareShape(); }
 
     /** Sets the offset (as raw value for the tanh-shaper for 303-square waveform - internal 
     parameter, to be scrapped eventually. */
     void setTanhShaperOffset(double newOffset) 
-    { waveTable2.setTanhShaperOffsetFor303Square(newOffset); }
+    { hot.waveTable2.setTanhShaperOffsetFor303Square(newOffset); updateSquareShape(); }
 
     /** Sets the cutoff frequency for the highpass before the main filter. */
-    void setPreFilterHighpass(double newCutoff) { highpass1.setCutoff(newCutoff); }
+    void setPreFilterHighpass(double newCutoff) { hot.highpass1.setCutoff(newCutoff); }
 
     /** Sets the cutoff frequency for the highpass inside the feedback loop of the main filter. */
-    void setFeedbackHighpass(double newCutoff) { filter.setFeedbackHighpassCutoff(newCutoff); }
+    void setFeedbackHighpass(double newCutoff) { hot.filter.setFeedbackHighpassCutoff(newCutoff); }
 
     /** Sets the cutoff frequency for the highpass after the main filter. */
-    void setPostFilterHighpass(double newCutoff) { highpass2.setCutoff(newCutoff); }
+    void setPostFilterHighpass(double newCutoff) 
+    { 
+      cold.highpass2.setCutoff(newCutoff); 
+      updatePostFilters(); 
+    }
 
     /** Sets the phase shift of tanh-shaped square wave with respect to the saw-wave (in degrees)
     - this is important when the two are mixed. */
-    void setSquarePhaseShift(double newShift) { waveTable2.set303SquarePhaseShift(newShift); }
+    void setSquarePhaseShift(double newShift) 
+    { hot.waveTable2.set303SquarePhaseShift(newShift); updateSquareShape(); }
+
+    /** Lets the oscillator use an externally rendered (e.g. cached) table for the square waveform 
+    instead of the built-in waveTable2 - this avoids rendering the mip-map on the audio thread when 
+    the shaper parameters change. Passing NULL switches back to waveTable2. The table must stay 
+    alive as long as it is in use. */
+    void setSquareWaveTable(MipMappedWaveTable* newTable) 
+    { hot.oscillator.setWaveTable2(newTable != NULL ? newTable : &hot.waveTable2); updateSquareShape(); }
 
     /** Sets the slide-time (in ms). The TB-303 had a slide time of 60 ms. */
     void setSlideTime(double newSlideTime);
@@ -116,41 +166,83 @@ namespace rosic
     Devil Fish provides range of 0.3...30 ms for this parameter. */
     void setNormalAttack(double newNormalAttack) 
     { 
-      normalAttack = newNormalAttack; 
-      rc1.setTimeConstant(normalAttack);
+      cold.normalAttack = newNormalAttack; 
+      hot.rc1.setTimeConstant(cold.normalAttack);
     }
 
     /** Sets the filter envelope's attack time for accented notes (in milliseconds). In the 
     Devil Fish, accented notes have a fixed attack time of 3 ms.  */
     void setAccentAttack(double newAccentAttack) 
     { 
-      accentAttack = newAccentAttack; 
-      rc2.setTimeConstant(accentAttack);
+      cold.accentAttack = newAccentAttack; 
+      hot.rc2.setTimeConstant(cold.accentAttack);
     }
 
     /** Sets the filter envelope's decay time for accented notes (in milliseconds). 
     Devil Fish provides range of 30...3000 ms for this parameter. On the normal 303, this 
     parameter was fixed to 200 ms.  */
-    void setAccentDecay(double newAccentDecay) { accentDecay = newAccentDecay; }
+    void setAccentDecay(double newAccentDecay) { cold.accentDecay = newAccentDecay; }
 
     /** Sets the amplitudes envelope's decay time (in milliseconds). Devil Fish provides range of 
     16...3000 ms for this parameter. On the normal 303, this parameter was fixed to 
     approximately 3-4 seconds.  */
-    void setAmpDecay(double newAmpDecay) { ampEnv.setDecay(newAmpDecay); }
+    void setAmpDecay(double newAmpDecay) { hot.ampEnv.setDecay(newAmpDecay); }
 
     /** Sets the amplitudes envelope's release time (in milliseconds). On the normal 303, this 
     parameter was fixed to .....  */
     void setAmpRelease(double newAmpRelease) 
     { 
-      normalAmpRelease = newAmpRelease;
-      ampEnv.setRelease(newAmpRelease); 
+      cold.normalAmpRelease = newAmpRelease;
+      hot.ampEnv.setRelease(newAmpRelease); 
     }
 
-    /** Sets external input mix-level and audio sample values */
+    /** Sets the level of the sub-oscillator (a square wave 1 or 2 octaves below the oscillator) 
+    as raw amplitude factor where 1.0 matches the amplitude of the oscillator's square wave. */
+    void setSubOscLevel(double newLevel) { cold.subOscLevel = newLevel; hot.subOscGain = 0.5*newLevel; }
+
+    /** Selects whether the sub-oscillator sounds 1 or 2 octaves below the oscillator. */
+    void setSubOscOctave(int newOctave) { hot.subOscOctave = newOctave <= 1 ? 1 : 2; }
+
+    /** Sets the mix of the noise generator (linear crossfade between the oscillator and the noise, 
+    0.0...1.0). The noise is generated at the oversampled rate. */
+    void setNoiseMix(double newMix) { hot.noiseMix = newMix; }
+
+    /** Selects the noise type (@see NoiseGenerator::modes). */
+    void setNoiseMode(int newMode) { hot.noise.setMode(newMode); }
+
+    /** Seeds the noise generator. */
+    void setNoiseSeed(unsigned int newSeed) { hot.noise.setSeed(newSeed); }
+
+    /** Selects the shaper type of the post-filter drive stage (@see DriveStage::modes). */
+    void setDriveMode(int newMode) { hot.driveStage.setMode(newMode); }
+
+    /** Sets the gain in front of the post-filter drive stage's shaper in decibels. */
+    void setDrive(double newDrive) { hot.driveStage.setDrive(newDrive); }
+
+    /** Sets the cutoff frequency of the post-filter drive stage's tone filter (in Hz). */
+    void setDriveTone(double newTone) { hot.driveStage.setTone(newTone); }
+
+    /** Moves the post-filter drive stage out of the oversampled loop (behind the anti-aliasing 
+    filter). This is a different tradeoff between aliasing and latency, not a cheaper mode: the 
+    oversampled loop and the decimator run either way, and with antiderivative anti-aliasing 
+    (@see setDriveAntiAliasing) the shaper costs about as much per output sample as the 4 
+    oversampled evaluations of the soft, hard and asymmetric shapers, or more (only tanh gets 
+    cheaper). It aliases more than the oversampled stage and delays the driven signal by half a 
+    sample (1st order) or one sample (2nd order) - see Open303DriveBenchmark. */
+    void setDriveAtBaseRate(bool shouldRunAtBaseRate);
+
+    /** Selects the method for evaluating the drive stage's shaper 
+    (@see DriveStage::antiAliasingMethods). */
+    void setDriveAntiAliasing(int newMethod) { hot.driveStage.setAntiAliasing(newMethod); }
+
+    /** Sets external input mix-level and audio sample values. The samples are interpolated up to
+    the oversampled rate (@see PolyphaseUpsampler) - but only while the mix is nonzero. */
     void setExtIn(double newExtInMix, double newExtInSample)
     {
-      extInMix = newExtInMix;
-      extInSample = newExtInSample * extInTrim;
+      if( hot.extInMix == 0.0 && newExtInMix != 0.0 )
+        hot.extInUpsampler.reset(newExtInSample * hot.extInTrim); // resume without stale history
+      hot.extInMix = newExtInMix;
+      hot.extInSample = newExtInSample * hot.extInTrim;
     }
 
     //-----------------------------------------------------------------------------------------------
@@ -158,85 +250,136 @@ namespace rosic
 
     /** Returns the waveform as a continuous value between 0...1 where 0 means pure saw and 1 means 
     pure square. */
-    double getWaveform() const { return oscillator.getBlendFactor(); }
+    double getWaveform() const { return hot.oscillator.getBlendFactor(); }
+
+    /** Returns the interpolation method of the oscillator. */
+    int getOscillatorInterpolation() const { return hot.oscillator.getInterpolationMethod(); }
+
+    /** Returns the backend of the oscillator. */
+    int getOscillatorBackend() const { return hot.oscillator.getBackend(); }
+
+    /** Returns the sample-rate (in Hz). */
+    double getSampleRate() const { return cold.sampleRate; }
 
     /** Sets the master tuning frequency for note A4 (usually 440 Hz). */
-    double getTuning() const { return tuning; }
+    double getTuning() const { return cold.tuning; }
 
     /** Returns the filter's nominal cutoff frequency (in Hz). */
-    double getCutoff() const { return cutoff; }
+    double getCutoff() const { return hot.cutoff; }
 
     /** Returns the filter's resonance amount (in percent) */
-    double getResonance() const { return filter.getResonance(); }
+    double getResonance() const { return hot.filter.getResonance(); }
 
     /** Returns the morphing filter morph position */
-    double getFilterMorph() { return filter.getFilterMorph(); }
+    double getFilterMorph() { return hot.filter.getFilterMorph(); }
+
+    /** Returns the solution of the 303 ladder. @see TeeBeeFilterMorph::ladders */
+    int getFilterLadder() const { return hot.filter.getLadder(); }
+
+    /** Returns the depth of the cutoff modulation by the oscillator in octaves. */
+    double getFilterFm() const { return hot.filterFm; }
 
     /** Returns the modulation depth of the filter's cutoff frequency by the filter-envelope 
     generator (in percent). */
-    double getEnvMod() const { return envMod; }
+    double getEnvMod() const { return cold.envMod; }
 
     /** Returns the filter envelope's decay time for non-accented notes (in milliseconds). */
-    double getDecay() const { return normalDecay; }
+    double getDecay() const { return cold.normalDecay; }
 
     /** Returns the accent (in percent). */
-    double getAccent() const { return 100.0 * accent; }
+    double getAccent() const { return 100.0 * cold.accent; }
 
     /** Returns the master volume level (in dB). */
-    double getVolume() const { return level; }
+    double getVolume() const { return cold.level; }
 
     //  from here: parameters which were not available to the user in the 303:
 
     /** Returns the amplitudes envelope's sustain level (in dB). */
-    double getAmpSustain() const { return amp2dB(ampEnv.getSustain()); }
+    double getAmpSustain() const { return amp2dB(hot.ampEnv.getSustain()); }
 
     /** Returns the drive (in dB) for the tanh-shaper for 303-square waveform - internal parameter, 
     to be scrapped eventually. */
     double getTanhShaperDrive() const 
-    { return waveTable2.getTanhShaperDriveFor303Square(); }
+    { return hot.oscillator.getWaveTable2()->getTanhShaperDriveFor303Square(); }
 
     /** Returns the offset (as raw value for the tanh-shaper for 303-square waveform - internal 
     parameter, to be scrapped eventually. */   
     double getTanhShaperOffset() const 
-    { return waveTable2.getTanhShaperOffsetFor303Square(); }
+    { return hot.oscillator.getWaveTable2()->getTanhShaperOffsetFor303Square(); }
 
     /** Returns the cutoff frequency for the highpass before the main filter. */
-    double getPreFilterHighpass() const { return highpass1.getCutoff(); }
+    double getPreFilterHighpass() const { return hot.highpass1.getCutoff(); }
 
     /** Retruns the cutoff frequency for the highpass inside the feedback loop of the main 
     filter. */
-    double getFeedbackHighpass() const { return filter.getFeedbackHighpassCutoff(); }
+    double getFeedbackHighpass() const { return hot.filter.getFeedbackHighpassCutoff(); }
 
     /** Returns the cutoff frequency for the highpass after the main filter. */
-    double getPostFilterHighpass() const { return highpass2.getCutoff(); }
+    double getPostFilterHighpass() const { return cold.highpass2.getCutoff(); }
 
     /** Returns the phase shift of tanh-shaped square wave with respect to the saw-wave (in degrees)
     - this is important when the two are mixed. */
-    double getSquarePhaseShift() const { return waveTable2.get303SquarePhaseShift(); }
+    double getSquarePhaseShift() const 
+    { return hot.oscillator.getWaveTable2()->get303SquarePhaseShift(); }
+
+    /** Returns the table that is currently used for the square waveform (either the built-in 
+    waveTable2 or one passed to setSquareWaveTable). */
+    MipMappedWaveTable* getSquareWaveTable() const { return hot.oscillator.getWaveTable2(); }
 
     /** Returns the slide-time (in ms). */
-    double getSlideTime() const { return slideTime; }
+    double getSlideTime() const { return cold.slideTime; }
 
     /** Returns the filter envelope's attack time for non-accented notes (in milliseconds). */
-    double getNormalAttack() const { return normalAttack; }
+    double getNormalAttack() const { return cold.normalAttack; }
 
     /** Returns the filter envelope's attack time for non-accented notes (in milliseconds). */
-    double getAccentAttack() const { return accentAttack; }
+    double getAccentAttack() const { return cold.accentAttack; }
 
     /** Returns the filter envelope's decay time for non-accented notes (in milliseconds). */
-    double getAccentDecay() const { return accentDecay; }
+    double getAccentDecay() const { return cold.accentDecay; }
 
     /** Returns the amplitudes envelope's decay time (in milliseconds). */
-    double getAmpDecay() const { return ampEnv.getDecay(); }
+    double getAmpDecay() const { return hot.ampEnv.getDecay(); }
 
     /** Returns the amplitudes envelope's release time (in milliseconds). */
-    double getAmpRelease() const { return normalAmpRelease; }
+    double getAmpRelease() const { return cold.normalAmpRelease; }
+
+    /** Returns the level of the sub-oscillator. */
+    double getSubOscLevel() const { return cold.subOscLevel; }
+
+    /** Returns the number of octaves (1 or 2) that the sub-oscillator sounds below the 
+    oscillator. */
+    int getSubOscOctave() const { return hot.subOscOctave; }
+
+    /** Returns the mix of the noise generator. */
+    double getNoiseMix() const { return hot.noiseMix; }
+
+    /** Returns the noise type (@see NoiseGenerator::modes). */
+    int getNoiseMode() const { return hot.noise.getMode(); }
+
+    /** Returns the shaper type of the post-filter drive stage (@see DriveStage::modes). */
+    int getDriveMode() const { return hot.driveStage.getMode(); }
+
+    /** Returns the gain in front of the post-filter drive stage's shaper in decibels. */
+    double getDrive() const { return hot.driveStage.getDrive(); }
+
+    /** Returns the cutoff frequency of the post-filter drive stage's tone filter (in Hz). */
+    double getDriveTone() const { return hot.driveStage.getTone(); }
+
+    /** True, if the post-filter drive stage runs at the base rate. */
+    bool isDriveAtBaseRate() const { return hot.driveAtBaseRate; }
+
+    /** Returns the number of samples between updates of the envelope-driven filter cutoff. */
+    int getModulationSubRate() const { return hot.modSubRate; }
+
+    /** Returns the method for evaluating the drive stage's shaper. */
+    int getDriveAntiAliasing() const { return hot.driveStage.getAntiAliasing(); }
 
     /** Returns external input mixlevel */
-    double getExtInMix() const { return extInMix; }
+    double getExtInMix() const { return hot.extInMix; }
 
     /** Returns the state all filter-related variables */
-    void  getFilterState() { filter.getFilterState(); };
+    void  getFilterState() { hot.filter.getFilterState(); };
 
 
     //-----------------------------------------------------------------------------------------------
@@ -245,6 +388,25 @@ namespace rosic
     /** Calculates one output sample at a time. */
     INLINE double getSample(); 
 
+    /** Maximum number of samples that renderSample can collect before finishBlock must be 
+    called. */
+    static const int maxBlockSize = 64;
+
+    /** Calculates one output sample up to the filters behind the decimation and collects it, 
+    which is cheaper than getSample when the output is needed in blocks. The collected samples
+    are finished and written out by finishBlock - call it after at most maxBlockSize samples and
+    before any note events. */
+    INLINE void renderSample();
+
+    /** Calls renderSample numSamples times. The kernel of the main filter is picked once for all of
+    them, so it is inlined into the loop - no parameters may change in between. */
+    INLINE void renderSamples(int numSamples);
+
+    /** Runs the samples collected by renderSample through the filters behind the decimation 
+    (all together, @see PostFilterChain), applies the amplitude and writes them to 'out'. */
+    template<class T>
+    INLINE void finishBlock(T *out);
+
     //-----------------------------------------------------------------------------------------------
     // event handling:
 
@@ -254,9 +416,19 @@ namespace rosic
     /** Turns all possibly running notes off. */
     void allNotesOff();
 
+    /** Silences the engine and puts its hot state back to the state after construction, so that 
+    it can be reused for another voice (for example from an Open303Pool). The parameters in the 
+    cold state and the coefficients of the embedded objects are kept. The filter, oscillator and 
+    noise states are cleared by the next triggerNote. */
+    void reset();
+
     /** Sets the pitchbend value in semitones. */ 
     void setPitchBend(double newPitchBend);
 
+    /** Sets the pitchbend as frequency factor - for callers that convert from semitones 
+    themselves (for example with exp2Lookup, per sample). */
+    void setPitchBendFactor(double newFactor) { hot.pitchWheelFactor = newFactor; }
+
      /* Triggers a note (called either directly in noteOn or in getSample when the sequencer is 
     used). */
     void triggerNote(int noteNumber, bool hasAccent);
@@ -269,21 +441,9 @@ namespace rosic
     used). */
     void releaseNote(int noteNumber);
 
-    //-----------------------------------------------------------------------------------------------
-    // embedded objects: 
-
-    MipMappedWaveTable        waveTable1, waveTable2;
-    BlendOscillator           oscillator;
-    //TeeBeeFilter              filter;  // standard filter
-    TeeBeeFilterMorph         filter; // morphing filter
-    AnalogEnvelope            ampEnv; 
-    DecayEnvelope             mainEnv;
-    LeakyIntegrator           pitchSlewLimiter;
-    BiquadFilter              ampDeClicker;
-    LeakyIntegrator           rc1, rc2;
-    OnePoleFilter             highpass1, highpass2, allpass; 
-    BiquadFilter              notch;
-    EllipticQuarterBandFilter antiAliasFilter;
+    /** Passes the coefficients of allpass, highpass2, notch and ampDeClicker on to postFilters -
+    to be called after changing these filters directly. */
+    void updatePostFilters();
 
   protected:
 
@@ -300,41 +460,108 @@ namespace rosic
     main envelope generator. */
     void updateNormalizer2();
 
+    /** Passes the shaper settings of the current square wavetable on to the oscillator (for its 
+    POLYBLEP backend). */
+    void updateSquareShape();
+
+    /** renderSample with the kernel of the main filter for mode M of its filter0 (@see 
+    TeeBeeFilterMorph::getSampleForMode). */
+    template<int M>
+    INLINE void renderSampleForMode();
+
     static const int oversampling = 4;
+    static_assert(PolyphaseUpsampler::factor == oversampling, "extInUpsampler must match the oversampling");
 
-    double tuning;           // master tuning for A4 in Hz
-    double ampScaler;        // final volume as raw factor
-    double oscFreq;          // frequecy of the oscillator (without pitchbend)
-    double sampleRate;       // the (non-oversampled) sample rate
-    double level;            // master volume level (in dB)
-    double levelByVel;       // velocity dependence of the level (in dB)
-    double accent;           // scales all "byVel" parameters
-    double slideTime;        // the time to slide from one note to another (in ms)
-    double cutoff;           // nominal cutoff frequency of the filter
-    double envMod;           // strength of the envelope modulation in percent
-    double envUpFraction;    // fraction of the envelope that goes upward
-    double envOffset;        // offset for the normalized envelope ('bipolarity' parameter)
-    double envScaler;        // scale-factor for the normalized envelope (derived from envMod)
-    double normalAttack;     // attack time for the filter envelope on non-accented notes
-    double accentAttack;     // attack time for the filter envelope on accented notes
-    double normalDecay;      // decay time for the filter envelope on non-accented notes
-    double accentDecay;      // decay time for the filter envelope on accented notes
-    double normalAmpRelease; // amp-env release time for non-accented notes
-    double accentAmpRelease; // amp-env release time for accented notes
-    double accentGain;       // between 0.0...1.0 - to scale the 3rd amp-envelope on accents
-    double filterDrive;      // filter overdrive
-    double extInMix;         // mix of the external input (0.0...1.0)
-    double extInSample;      // external input to the filter
-    double extInTrim;        // level trim for the external input
-
-    double pitchWheelFactor; // scale factor for oscillator frequency from pitch-wheel
-    double n1, n2;           // normalizers for the RCs that are driven by the MEG
-    int    currentNote;      // note which is currently played (-1 if none)
-    int    currentVel;       // velocity of currently played note
-    bool   idle;             // flag to indicate that we have currently nothing to do in getSample
-
-    // MIDI notes list
-    list<MidiNoteEvent> noteList;
+    static const int cacheLineSize = 64;
+
+    /** State that renderSample and finishBlock read or update per sample, in one contiguous block:
+    the engine's own scalars (doubles first, then ints and flags, so there are no padding holes) 
+    followed by the embedded objects that run per sample, in the order renderSample uses them - 
+    their states (the ladder's y1...y4, the oscillator's phase and increment, the envelope 
+    outputs, ...) live in here together with their coefficients. */
+    struct alignas(cacheLineSize) HotState
+    {
+      double oscFreq;          // frequecy of the oscillator (without pitchbend)
+      double pitchWheelFactor; // scale factor for oscillator frequency from pitch-wheel
+      double n1, n2;           // normalizers for the RCs that are driven by the MEG
+      double accentGain;       // between 0.0...1.0 - to scale the 3rd amp-envelope on accents
+      double envScaler;        // scale-factor for the normalized envelope (derived from envMod)
+      double envOffset;        // offset for the normalized envelope ('bipolarity' parameter)
+      double cutoff;           // nominal cutoff frequency of the filter
+      double lastModExponent;  // cutoff modulation (in octaves) at the last sub-rate point
+      double ampScaler;        // final volume as raw factor
+      double subOscGain;       // amplitude factor for the sub-oscillator (derived from subOscLevel)
+      double noiseMix;         // mix of the noise generator (0.0...1.0)
+      double filterFm;         // cutoff modulation by the oscillator (octaves per unit amplitude)
+      double extInMix;         // mix of the external input (0.0...1.0)
+      double extInSample;      // external input to the filter
+      double extInTrim;        // level trim for the external input
+      int    modSubRate;       // samples between updates of the envelope-driven cutoff
+      int    modCounter;       // samples until the next update of the envelope-driven cutoff
+      int    modAttackSamples; // samples until the envelope-driven cutoff may use the sub-rate
+      int    blockLength;      // number of samples collected by renderSample
+      int    subOscOctave;     // 1 or 2 octaves below the oscillator
+      bool   driveAtBaseRate;  // flag to run the drive stage behind the anti-aliasing filter
+      bool   idle;             // flag to indicate that we have currently nothing to do in getSample
+
+      LeakyIntegrator           pitchSlewLimiter;
+      DecayEnvelope             mainEnv;
+      LeakyIntegrator           rc1, rc2;
+      //TeeBeeFilter              filter;  // standard filter
+      TeeBeeFilterMorph         filter; // morphing filter
+      AnalogEnvelope            ampEnv; 
+      NoiseGenerator            noise;
+      PolyphaseUpsampler        extInUpsampler;
+      BlendOscillator           oscillator;
+      MipMappedWaveTable        waveTable1, waveTable2;
+      OnePoleFilter             highpass1;
+      DriveStage                driveStage;
+      EllipticQuarterBandFilter antiAliasFilter;
+      PostFilterChain           postFilters;  // runs allpass, highpass2, notch and ampDeClicker
+    };
+    // 58 cache lines, one more with OPEN303_FLOAT_WAVETABLES (the wavetables' interleaving members):
+    static_assert(sizeof(HotState) <= 59*cacheLineSize, "HotState exceeds its cache line budget");
+
+    /** Parameters that are only read when they are set or when a note starts, and the filters that
+    only hold coefficients. */
+    struct ColdState
+    {
+      double tuning;           // master tuning for A4 in Hz
+      double sampleRate;       // the (non-oversampled) sample rate
+      double level;            // master volume level (in dB)
+      double levelByVel;       // velocity dependence of the level (in dB)
+      double accent;           // scales all "byVel" parameters
+      double slideTime;        // the time to slide from one note to another (in ms)
+      double envMod;           // strength of the envelope modulation in percent
+      double envUpFraction;    // fraction of the envelope that goes upward
+      double normalAttack;     // attack time for the filter envelope on non-accented notes
+      double accentAttack;     // attack time for the filter envelope on accented notes
+      double normalDecay;      // decay time for the filter envelope on non-accented notes
+      double accentDecay;      // decay time for the filter envelope on accented notes
+      double normalAmpRelease; // amp-env release time for non-accented notes
+      double accentAmpRelease; // amp-env release time for accented notes
+      double filterDrive;      // filter overdrive
+      double subOscLevel;      // level of the sub-oscillator
+      int    currentNote;      // note which is currently played (-1 if none)
+      int    currentVel;       // velocity of currently played note
+
+      // MIDI notes list
+      list<MidiNoteEvent> noteList;
+
+      // only hold the coefficients for postFilters:
+      BiquadFilter              ampDeClicker;
+      OnePoleFilter             highpass2, allpass; 
+      BiquadFilter              notch;
+    };
+
+    HotState  hot;
+    ColdState cold;
+
+    // samples collected by renderSample - decimated signal, amplitude (before the declicker) and
+    // volume (each starting on a cache line of its own):
+    alignas(cacheLineSize) double blockSignal[maxBlockSize];
+    alignas(cacheLineSize) double blockAmplitude[maxBlockSize];
+    alignas(cacheLineSize) double blockScaler[maxBlockSize];
 
   };
 
@@ -342,60 +569,171 @@ namespace rosic
   // inlined functions:
 
   INLINE double Open303::getSample()
+  {
+    double out;
+    renderSample();
+    finishBlock(&out);
+    return out;
+  }
+
+  INLINE void Open303::renderSample()
+  {
+    renderSamples(1);
+  }
+
+  INLINE void Open303::renderSamples(int numSamples)
+  {
+    switch( hot.filter.getFilter0Mode() )
+    {
+    case TeeBeeFilter::TB_303:
+      for(int n=0; n<numSamples; n++)
+        renderSampleForMode<TeeBeeFilter::TB_303>();
+      break;
+    case TeeBeeFilter::TB_303_ZDF:
+      for(int n=0; n<numSamples; n++)
+        renderSampleForMode<TeeBeeFilter::TB_303_ZDF>();
+      break;
+    case TeeBeeFilter::TB_303_NONLINEAR:
+      for(int n=0; n<numSamples; n++)
+        renderSampleForMode<TeeBeeFilter::TB_303_NONLINEAR>();
+      break;
+    default:
+      for(int n=0; n<numSamples; n++)
+        renderSampleForMode<TeeBeeFilter::HP_24>();
+      break;
+    }
+  }
+
+  template<int M>
+  INLINE void Open303::renderSampleForMode()
   {
     //if( sequencer.getSequencerMode() == AcidSequencer::OFF && ampEnv.endIsReached() )
     //  return 0.0;
-    if( idle )
-      return 0.0;
+    if( hot.idle )
+    {
+      blockSignal[hot.blockLength]    = 0.0;
+      blockAmplitude[hot.blockLength] = 0.0;
+      blockScaler[hot.blockLength]    = 0.0;
+      hot.blockLength++;
+      return;
+    }
 
     // calculate instantaneous oscillator frequency and set up the oscillator:
-    double instFreq = pitchSlewLimiter.getSample(oscFreq);
-    oscillator.setFrequency(instFreq*pitchWheelFactor);
-    oscillator.calculateIncrement();
+    double instFreq = hot.pitchSlewLimiter.getSample(hot.oscFreq);
+    hot.oscillator.setFrequency(instFreq*hot.pitchWheelFactor);
+    hot.oscillator.calculateIncrement();
 
     // calculate instantaneous cutoff frequency from the nominal cutoff and all its modifiers and 
     // set up the filter:
-    double mainEnvOut = mainEnv.getSample();
-    double tmp1       = n1 * rc1.getSample(mainEnvOut);
+    double mainEnvOut = hot.mainEnv.getSample();
+    double tmp1       = hot.n1 * hot.rc1.getSample(mainEnvOut);
     double tmp2       = 0.0;
-    if( accentGain > 0.0 )
+    if( hot.accentGain > 0.0 )
       tmp2 = mainEnvOut;
-    tmp2 = n2 * rc2.getSample(tmp2);  
-    tmp1 = envScaler * ( tmp1 - envOffset );  // seems not to work yet
-    tmp2 = accentGain*tmp2;
-    double instCutoff = cutoff * pow(2.0, tmp1+tmp2);
-    filter.setCutoff(instCutoff);
+    tmp2 = hot.n2 * hot.rc2.getSample(tmp2);  
+    bool modPoint = --hot.modCounter <= 0;
+    if( modPoint || hot.modAttackSamples > 0 )
+    {
+      // at the modulation sub-rate - in between, the coefficients are interpolated, except during
+      // the attack where the envelope moves too fast for that:
+      tmp1 = hot.envScaler * ( tmp1 - hot.envOffset );  // seems not to work yet
+      tmp2 = hot.accentGain*tmp2;
+      double modExponent = tmp1+tmp2;
+      int    rampLength  = hot.modSubRate;
+      if( hot.modAttackSamples > 0 )
+      {
+        // update every sample - but keep the points at the sub-rate for the extrapolation after 
+        // the attack:
+        rampLength = 1;
+        if( modPoint )
+          hot.lastModExponent = modExponent;
+      }
+      else if( hot.modSubRate > 1 )
+      {
+        // ramp towards the modulation at the next point, extrapolated from the last one (so the
+        // interpolation doesn't lag behind the envelope) - right after a note was triggered, 
+        // there is no last point, so the cutoff jumps there:
+        double lastExponent = hot.lastModExponent;
+        hot.lastModExponent = modExponent;
+        if( isnan(lastExponent) )
+          rampLength = 1;
+        else
+          modExponent += modExponent - lastExponent;
+      }
+      double instCutoff = hot.cutoff * pow(2.0, modExponent);
+      hot.filter.setCutoffRamp(instCutoff, rampLength);
+      if( modPoint )
+        hot.modCounter = hot.modSubRate;
+    }
+    if( hot.modAttackSamples > 0 )
+      hot.modAttackSamples--;
+    hot.filter.advanceCoefficients();
 
-    double ampEnvOut = ampEnv.getSample();
+    double ampEnvOut = hot.ampEnv.getSample();
     //ampEnvOut += 0.45*filterEnvOut + accentGain*6.8*filterEnvOut; 
-    if( ampEnv.isNoteOn() )
-      ampEnvOut += 0.45*mainEnvOut + accentGain*4.0*mainEnvOut; 
-    ampEnvOut = ampDeClicker.getSample(ampEnvOut);
+    if( hot.ampEnv.isNoteOn() )
+      ampEnvOut += 0.45*mainEnvOut + hot.accentGain*4.0*mainEnvOut; 
+
+    // noise for the oversampled calculations, one block per sample:
+    double noiseBlock[oversampling];
+    if( hot.noiseMix > 0.0 )
+      hot.noise.getSamples(noiseBlock, oversampling, hot.oscillator.getCycleIncrement());
+
+    // the external input at the oversampled rate:
+    double extInBlock[oversampling];
+    if( hot.extInMix != 0.0 )
+      hot.extInUpsampler.getSamples(hot.extInSample, extInBlock);
 
     // oversampled calculations:
-    double tmp;
+    double tmp, osc;
+    if( hot.filterFm != 0.0 )
+      hot.filter.beginCutoffFm();
     for(int i=1; i<=oversampling; i++)
     {
-      tmp  = -oscillator.getSample();                 // the raw oscillator signal
+      tmp  = 0.0;
+      if( hot.subOscGain != 0.0 )                         // sub-oscillator (must precede getSample)
+        tmp = hot.subOscGain * hot.oscillator.getSubSample(hot.subOscOctave);
+      osc  = hot.oscillator.getSample();
+      tmp  = -(osc + tmp);                            // the raw oscillator signal
       //tmp  = linearBlend(tmp, extInSample, extInMix); // external input mixed in (linear crossfade bewtween osc and external input)
-      tmp  = highpass1.getSample(tmp);                // pre-filter highpass
-      tmp  = linearBlend(tmp, extInSample, extInMix); // external input mixed in (linear crossfade bewtween osc and external input)
-      tmp  = filter.getSample(tmp);                   // now it's filtered with 303 filter
-      tmp  = antiAliasFilter.getSample(tmp);          // anti-aliasing filtered
+      tmp  = hot.highpass1.getSample(tmp);            // pre-filter highpass
+      if( hot.noiseMix > 0.0 )                            // noise mixed in (linear crossfade)
+        tmp = linearBlend(tmp, noiseBlock[i-1], hot.noiseMix);
+      if( hot.extInMix != 0.0 )                           // external input mixed in (linear crossfade bewtween osc and external input)
+        tmp = linearBlend(tmp, extInBlock[i-1], hot.extInMix);
+      if( hot.filterFm != 0.0 )                           // cutoff modulated by the oscillator
+        hot.filter.applyCutoffFm(exp2Lookup(hot.filterFm*osc));
+      tmp  = hot.filter.getSampleForMode<M>(tmp);               // now it's filtered with 303 filter
+      if( !hot.driveAtBaseRate )
+        tmp = hot.driveStage.getSample(tmp);          // post-filter distortion (if any)
+      tmp  = hot.antiAliasFilter.getSample(tmp);      // anti-aliasing filtered
     }
+    if( hot.filterFm != 0.0 )
+      hot.filter.endCutoffFm();
+    if( hot.driveAtBaseRate )
+      tmp = hot.driveStage.getSample(tmp);
 
+    // the allpass, highpass2, notch and the declicker of ampEnvOut follow in finishBlock - 
     // these filters may actually operate without oversampling (but only if we reset them in
     // triggerNote - avoid clicks)
-    tmp  = allpass.getSample(tmp);
-    tmp  = highpass2.getSample(tmp);        
-    tmp  = notch.getSample(tmp);
-    tmp *= ampEnvOut;   // amplified
-    tmp *= ampScaler;
+    blockSignal[hot.blockLength]    = tmp;
+    blockAmplitude[hot.blockLength] = ampEnvOut;
+    blockScaler[hot.blockLength]    = hot.ampScaler;
+    hot.blockLength++;
 
     // find out whether we may switch ourselves off for the next call:
-    idle = false;
+    hot.idle = false;
+  }
 
-    return tmp;
+  template<class T>
+  INLINE void Open303::finishBlock(T *out)
+  {
+    if( hot.blockLength == 0 )
+      return;
+    hot.postFilters.processBlock(blockSignal, blockAmplitude, hot.blockLength);
+    for(int n=0; n<hot.blockLength; n++)
+      out[n] = (T) (blockSignal[n] * blockAmplitude[n] * blockScaler[n]);  // amplified
+    hot.blockLength = 0;
   }
 
 } // End namespace rosic
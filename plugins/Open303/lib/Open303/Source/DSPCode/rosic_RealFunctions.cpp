@@ -1,3 +1,14 @@
 #include "rosic_RealFunctions.h"
 using namespace rosic;
 
+double rosic::exp2LookupTable[exp2LookupSize+1];
+
+// fills exp2LookupTable when the library is loaded:
+static struct Exp2LookupTableInitializer
+{
+  Exp2LookupTableInitializer()
+  {
+    for(int i=0; i<=exp2LookupSize; i++)
+      exp2LookupTable[i] = pow(2.0, (double) i / exp2LookupSize);
+  }
+} exp2LookupTableInitializer;
@@ -4,6 +4,7 @@
 // standard library includes:
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 // rosic includes:
 #include "GlobalFunctions.h"
@@ -12,6 +13,13 @@
 namespace rosic
 {
 
+  /** Size of the table of 2^x for x in 0...1 used by exp2Lookup. */
+  static const int exp2LookupSize = 1024;
+
+  /** The table of 2^x for x in 0...1 (with exp2LookupSize+1 entries) - filled when the library 
+  is loaded. */
+  extern double exp2LookupTable[exp2LookupSize+1];
+
   /** Inverse hyperbolic sine. */
   INLINE double asinh(double x);
 
@@ -25,12 +33,19 @@ namespace rosic
   /** Evaluates the quartic polynomial y = a4*x^4 + a3*x^3 + a2*x^2 + a1*x + a0 at x. */
   INLINE double evaluateQuartic(double x, double a0, double a1, double a2, double a3, double a4);
 
+  /** Approximates 2^x by linear interpolation in a table (relative error below 1.e-7) - much 
+  cheaper than exp or pow for mapping modulation signals per sample. */
+  INLINE double exp2Lookup(double x);
+
   /** foldover at the specified value */
   INLINE double foldOver(double x, double min, double max);
 
   /** Computes an integer power of x by successively multiplying x with itself. */
   INLINE double integerPower(double x, int exponent);
 
+  /** Same as linToExp but uses exp2Lookup - for mapping audio-rate parameter inputs. */
+  INLINE double linToExpLookup(double in, double inMin, double inMax, double outMin, double outMax);
+
   /** Generates a pseudo-random number between min and max. */
   INLINE double random(double min=0.0, double max=1.0);
 
@@ -87,6 +102,28 @@ namespace rosic
     return x*(a3*x2+a1) + x2*(a4*x2+a2) + a0;
   }
 
+  INLINE double exp2Lookup(double x)
+  {
+    // split x into the integer part, which goes directly into the exponent bits, and the 
+    // fractional part, which is looked up:
+    if( x != x )
+      x = 0.0;                 // NaN - don't let it reach the (int) casts
+    x         = clip(x, -1020.0, 1020.0);
+    double xf = floor(x);
+    int    xi = (int) xf;
+    double f  = (x-xf) * exp2LookupSize;
+    int    i  = (int) f;
+    if( i > exp2LookupSize-1 )
+      i = exp2LookupSize-1;    // x-xf rounds to 1.0 for tiny negative x
+    f        -= i;
+    double y  = exp2LookupTable[i] + f * (exp2LookupTable[i+1]-exp2LookupTable[i]);
+
+    UINT64 bits = ((UINT64) (xi+1023)) << 52;
+    double scaler;
+    memcpy(&scaler, &bits, sizeof(scaler));
+    return y * scaler;
+  }
+
   INLINE double foldOver(double x, double min, double max)
   {
     if( x > max )
@@ -104,6 +141,12 @@ namespace rosic
     return accu;
   }
 
+  INLINE double linToExpLookup(double in, double inMin, double inMax, double outMin, double outMax)
+  {
+    double tmp = (in-inMin) / (inMax-inMin);
+    return outMin * exp2Lookup(tmp * log2(outMax/outMin));
+  }
+
   INLINE double random(double min, double max)
   {
     double tmp = (1.0/RAND_MAX) * rand() ;  // between 0...1
@@ -2,6 +2,28 @@
 
 using namespace rosic;
 
+const TeeBeeFilter::SampleFunction TeeBeeFilter::sampleFunctions[NUM_MODES] =
+{
+  &TeeBeeFilter::getSampleForMode<FLAT>,
+  &TeeBeeFilter::getSampleForMode<LP_6>,
+  &TeeBeeFilter::getSampleForMode<LP_12>,
+  &TeeBeeFilter::getSampleForMode<LP_18>,
+  &TeeBeeFilter::getSampleForMode<LP_24>,
+  &TeeBeeFilter::getSampleForMode<HP_6>,
+  &TeeBeeFilter::getSampleForMode<HP_12>,
+  &TeeBeeFilter::getSampleForMode<HP_18>,
+  &TeeBeeFilter::getSampleForMode<HP_24>,
+  &TeeBeeFilter::getSampleForMode<BP_12_12>,
+  &TeeBeeFilter::getSampleForMode<BP_6_18>,
+  &TeeBeeFilter::getSampleForMode<BP_18_6>,
+  &TeeBeeFilter::getSampleForMode<BP_6_12>,
+  &TeeBeeFilter::getSampleForMode<BP_12_6>,
+  &TeeBeeFilter::getSampleForMode<BP_6_6>,
+  &TeeBeeFilter::getSampleForMode<TB_303>,
+  &TeeBeeFilter::getSampleForMode<TB_303_ZDF>,
+  &TeeBeeFilter::getSampleForMode<TB_303_NONLINEAR>
+};
+
 //-------------------------------------------------------------------------------------------------
 // construction/destruction:
 
@@ -14,6 +36,7 @@ TeeBeeFilter::TeeBeeFilter()
   resonanceSkewed     =     0.0;
   mode                =  TB_303;
   oldMode             =      -1;
+  sampleFunction      = sampleFunctions[mode];
   g                   =     8.0;
   gScale              =     1.0;
   sampleRate          = 44100.0;
@@ -21,6 +44,7 @@ TeeBeeFilter::TeeBeeFilter()
 
   feedbackHighpass.setMode(OnePoleFilter::HIGHPASS);
   feedbackHighpass.setCutoff(150.0);
+  calculateFeedbackHighpassZdf();
 
   setMode(mode);
   calculateCoefficientsExact();
@@ -46,6 +70,7 @@ void TeeBeeFilter::setSampleRate(double newSampleRate)
     sampleRate = newSampleRate;
   twoPiOverSampleRate = 2.0*PI/sampleRate;
   feedbackHighpass.setSampleRate(newSampleRate);
+  calculateFeedbackHighpassZdf();
   calculateCoefficientsExact();
 }
 
@@ -59,34 +84,47 @@ void TeeBeeFilter::setMode(int newMode)
 {
   if( (newMode >= 0) && (newMode < NUM_MODES) && (newMode != oldMode))
   {
-    mode = newMode;
+    mode           = newMode;
+    sampleFunction = sampleFunctions[mode];
     switch(mode)
     {
       // TODO: tweak g (gain) for every filter type to even-out output levels compared to TB_303 (FLAT) mode
       // Gain calculated in calculateCoefficientsApprox4() in TB_303 mode, g set below not used in "flat" pole-mixing mode
-      case FLAT:      c0 =  1.0; c1 =  0.0; c2 =  0.0; c3 =  0.0; c4 =  0.0;  g =  1.0; break;
-      case LP_6:      c0 =  0.0; c1 =  1.0; c2 =  0.0; c3 =  0.0; c4 =  0.0;  g =  8.0; break;
-      case LP_12:     c0 =  0.0; c1 =  0.0; c2 =  1.0; c3 =  0.0; c4 =  0.0;  g =  8.0; break;
-      case LP_18:     c0 =  0.0; c1 =  0.0; c2 =  0.0; c3 =  1.0; c4 =  0.0;  g =  8.0; break;
-      case LP_24:     c0 =  0.0; c1 =  0.0; c2 =  0.0; c3 =  0.0; c4 =  1.0;  g =  8.0; break;
-      case HP_6:      c0 =  1.0; c1 = -1.0; c2 =  0.0; c3 =  0.0; c4 =  0.0;  g =  8.0; break;
-      case HP_12:     c0 =  1.0; c1 = -2.0; c2 =  1.0; c3 =  0.0; c4 =  0.0;  g =  8.0; break;
-      case HP_18:     c0 =  1.0; c1 = -3.0; c2 =  3.0; c3 = -1.0; c4 =  0.0;  g =  8.0; break;
-      case HP_24:     c0 =  1.0; c1 = -4.0; c2 =  6.0; c3 = -4.0; c4 =  1.0;  g =  7.0; break; // used in morphing filter
-      case BP_12_12:  c0 =  0.0; c1 =  0.0; c2 =  1.0; c3 = -2.0; c4 =  1.0;  g = 15.0; break; // used in morphing filter
-      case BP_6_18:   c0 =  0.0; c1 =  0.0; c2 =  0.0; c3 =  1.0; c4 = -1.0;  g =  8.0; break;
-      case BP_18_6:   c0 =  0.0; c1 =  1.0; c2 = -3.0; c3 =  3.0; c4 = -1.0;  g =  8.0; break;
-      case BP_6_12:   c0 =  0.0; c1 =  0.0; c2 =  1.0; c3 = -1.0; c4 =  0.0;  g =  8.0; break;
-      case BP_12_6:   c0 =  0.0; c1 =  1.0; c2 = -2.0; c3 =  1.0; c4 =  0.0;  g =  8.0; break;
-      case BP_6_6:    c0 =  0.0; c1 =  1.0; c2 = -1.0; c3 =  0.0; c4 =  0.0;  g =  8.0; break;
-      default:        c0 =  1.0; c1 =  0.0; c2 =  0.0; c3 =  0.0; c4 =  0.0;  g =  1.0; break;  // flat
+      // The pole-mixing taps of each mode are in poleMix
+      case FLAT:      g =  1.0; break;
+      case LP_6:      g =  8.0; break;
+      case LP_12:     g =  8.0; break;
+      case LP_18:     g =  8.0; break;
+      case LP_24:     g =  8.0; break;
+      case HP_6:      g =  8.0; break;
+      case HP_12:     g =  8.0; break;
+      case HP_18:     g =  8.0; break;
+      case HP_24:     g =  7.0; break; // used in morphing filter
+      case BP_12_12:  g = 15.0; break; // used in morphing filter
+      case BP_6_18:   g =  8.0; break;
+      case BP_18_6:   g =  8.0; break;
+      case BP_6_12:   g =  8.0; break;
+      case BP_12_6:   g =  8.0; break;
+      case BP_6_6:    g =  8.0; break;
+      default:        g =  1.0; break;  // flat
     }
     calculateCoefficientsApprox4();
     reset();
+    fmNumCoefficients = 0; // the fit of the cutoff modulation is for the old mode
   }
   oldMode = newMode;
 }
 
+void TeeBeeFilter::calculateFeedbackHighpassZdf()
+{
+  // trapezoidal one-pole, so it can be solved together with the ladder:
+  double gh = tan(PI * feedbackHighpass.getCutoff() / sampleRate);
+  ah   = 1.0 / (1.0 + gh);
+  ghAh = gh * ah;
+  if( mode == TB_303_ZDF )
+    calculateCoefficientsZdf();
+}
+
 //-------------------------------------------------------------------------------------------------
 // others:
 
@@ -97,6 +135,9 @@ void TeeBeeFilter::reset()
   y2 = 0.0;
   y3 = 0.0;
   y4 = 0.0;
+  s1 = s2 = s3 = s4 = 0.0;
+  sh = 0.0;
+  x1 = x2 = x3 = x4 = 0.0;
 }
 
 void TeeBeeFilter::getFilterState()
@@ -119,11 +160,11 @@ void TeeBeeFilter::getFilterState()
   std::cout << "y4: " << y4 << "\n";
   
   std::cout << "Coefficients for combining various ouput stages:\n";
-  std::cout << "c0: " << c0 << "\n";
-  std::cout << "c1: " << c1 << "\n";
-  std::cout << "c2: " << c2 << "\n";
-  std::cout << "c3: " << c3 << "\n";
-  std::cout << "c4: " << c4 << "\n";
+  std::cout << "c0: " << poleMix[mode][0] << "\n";
+  std::cout << "c1: " << poleMix[mode][1] << "\n";
+  std::cout << "c2: " << poleMix[mode][2] << "\n";
+  std::cout << "c3: " << poleMix[mode][3] << "\n";
+  std::cout << "c4: " << poleMix[mode][4] << "\n";
 
   std::cout << "Feedback factor in the loop:\n";
   std::cout << "k: "  << k  << "\n";
@@ -48,9 +48,36 @@ namespace rosic
       BP_12_6   = 13,
       BP_6_6    = 14,
       TB_303    = 15,   // ala mystran & kunn (page 40 in the kvr-thread)
+      TB_303_ZDF = 16,  // same topology, zero-delay feedback (trapezoidal) solution
+      TB_303_NONLINEAR = 17, // TB_303 with a saturating input in each stage
       NUM_MODES
     };
 
+    /** Weights of the ladder input and the 4 stage outputs (y0...y4) that are mixed to form the 
+    output of the pole-mixing modes (the TB_303 modes only use y4). These are compile-time 
+    constants, so each mode's kernel only carries the taps that are actually nonzero. */
+    static constexpr double poleMix[NUM_MODES][5] =
+    {
+      { 1.0,  0.0,  0.0,  0.0,  0.0 },  // FLAT
+      { 0.0,  1.0,  0.0,  0.0,  0.0 },  // LP_6
+      { 0.0,  0.0,  1.0,  0.0,  0.0 },  // LP_12
+      { 0.0,  0.0,  0.0,  1.0,  0.0 },  // LP_18
+      { 0.0,  0.0,  0.0,  0.0,  1.0 },  // LP_24
+      { 1.0, -1.0,  0.0,  0.0,  0.0 },  // HP_6
+      { 1.0, -2.0,  1.0,  0.0,  0.0 },  // HP_12
+      { 1.0, -3.0,  3.0, -1.0,  0.0 },  // HP_18
+      { 1.0, -4.0,  6.0, -4.0,  1.0 },  // HP_24
+      { 0.0,  0.0,  1.0, -2.0,  1.0 },  // BP_12_12
+      { 0.0,  0.0,  0.0,  1.0, -1.0 },  // BP_6_18
+      { 0.0,  1.0, -3.0,  3.0, -1.0 },  // BP_18_6
+      { 0.0,  0.0,  1.0, -1.0,  0.0 },  // BP_6_12
+      { 0.0,  1.0, -2.0,  1.0,  0.0 },  // BP_12_6
+      { 0.0,  1.0, -1.0,  0.0,  0.0 },  // BP_6_6
+      { 0.0,  0.0,  0.0,  0.0,  1.0 },  // TB_303
+      { 0.0,  0.0,  0.0,  0.0,  1.0 },  // TB_303_ZDF
+      { 0.0,  0.0,  0.0,  0.0,  1.0 }   // TB_303_NONLINEAR
+    };
+
     //---------------------------------------------------------------------------------------------
     // construction/destruction:
 
@@ -71,6 +98,34 @@ namespace rosic
     manually later by calling calculateCoefficients. */
     INLINE void setCutoff(double newCutoff, bool updateCoefficients = true);
 
+    /** Sets the cutoff frequency like setCutoff, but instead of jumping there, the coefficients 
+    move linearly from their current values to the new ones over the next numSamples calls of 
+    advanceCoefficients. Any other coefficient update ends the ramp. */
+    INLINE void setCutoffRamp(double newCutoff, int numSamples);
+
+    /** Moves the coefficients one step along the ramp set up by setCutoffRamp (if any). To be 
+    called once per sample. */
+    INLINE void advanceCoefficients();
+
+    /** Sets the depth (in octaves) up to which the cutoff will be modulated with applyCutoffFm. 
+    setCutoffRamp then also fits each coefficient by a quadratic function of the modulation (in 
+    octaves) through the coefficients at the cutoff and at +-depth octaves around it. 0 turns 
+    this off. */
+    void setCutoffFmDepth(double newDepth) { fmDepth = fabs(newDepth); }
+
+    /** Stores the current coefficients as the unmodulated ones for applyCutoffFm. */
+    INLINE void beginCutoffFm();
+
+    /** Sets the coefficients for the cutoff multiplied by 'factor' (2^m for a modulation of m 
+    octaves, clipped to +-depth, @see setCutoffFmDepth) from the fit - much cheaper than 
+    calculating them, so this can be called per sample. Only valid between beginCutoffFm and 
+    endCutoffFm. Does nothing until the next setCutoffRamp after a change of the mode (which 
+    invalidates the fit). */
+    INLINE void applyCutoffFm(double factor);
+
+    /** Restores the unmodulated coefficients stored by beginCutoffFm. */
+    INLINE void endCutoffFm();
+
     /** Sets the resonance in percent where 100% is self oscillation. */
     INLINE void setResonance(double newResonance, bool updateCoefficients = true);
 
@@ -81,7 +136,11 @@ namespace rosic
     void setMode(int newMode);
 
     /** Sets the cutoff frequency for the highpass filter in the feedback path. */
-    void setFeedbackHighpassCutoff(double newCutoff) { feedbackHighpass.setCutoff(newCutoff); }
+    void setFeedbackHighpassCutoff(double newCutoff) 
+    { 
+      feedbackHighpass.setCutoff(newCutoff); 
+      calculateFeedbackHighpassZdf();
+    }
 
     //---------------------------------------------------------------------------------------------
     // inquiry:
@@ -107,8 +166,14 @@ namespace rosic
     //---------------------------------------------------------------------------------------------
     // audio processing:
 
-    /** Calculates one output sample at a time. */
-    INLINE double getSample(double in);
+    /** Calculates one output sample at a time, with the kernel that was selected for the 
+    current mode in setMode. */
+    INLINE double getSample(double in) { return (this->*sampleFunction)(in); }
+
+    /** Calculates one output sample with the kernel for the given mode, which must be the current
+    mode. For callers that know the mode at compile time, so the kernel can be inlined. */
+    template<int M>
+    INLINE double getSampleForMode(double in);
 
     //---------------------------------------------------------------------------------------------
     // others:
@@ -120,8 +185,17 @@ namespace rosic
     for normalized radian cutoff frequencies up to pi/4. */
     INLINE void calculateCoefficientsApprox4();
 
-    /** Implements the waveshaping nonlinearity between the stages. */
-    //INLINE double shape(double x);
+    /** Calculates the coefficients of the TB_303_ZDF mode. Called from the other two 
+    calculateCoefficients functions in this mode. */
+    INLINE void calculateCoefficientsZdf();
+
+    /** Calculates the coefficients of the feedback highpass for the TB_303_ZDF mode. */
+    void calculateFeedbackHighpassZdf();
+
+    /** Implements the saturation of the stage drives in the TB_303_NONLINEAR mode, as the gain
+    tanh(x)/x (1 at x = 0, falling towards 0) of the rational approximation tanhApprox - without 
+    branches or library calls, so it vectorizes. */
+    static INLINE double shapeGain(double x);
 
     /** Resets the internal state variables. */
     void reset();
@@ -130,9 +204,20 @@ namespace rosic
 
   protected:
 
+    /** Copies the coefficients that setCutoffRamp and applyCutoffFm work on (b0, a1, k, g and in 
+    the TB_303_ZDF mode also the coefficients of the zero-delay feedback solution) to 'c' and 
+    returns how many there are. */
+    INLINE int storeCoefficients(double *c) const;
+
+    /** Sets the coefficients from 'c', in the order of storeCoefficients. */
+    INLINE void loadCoefficients(const double *c);
+
+    /** Fits the coefficients as quadratic functions of the cutoff modulation in octaves, around
+    the current cutoff (@see setCutoffFmDepth). */
+    INLINE void fitCutoffFm();
+
     double b0{0.132792}, a1{-0.867208};       // coefficients for the first order sections
     double y1{0}, y2{0}, y3{0}, y4{0};        // output signals of the 4 filter stages 
-    double c0{1}, c1{0}, c2{0}, c3{0}, c4{0}; // coefficients for combining various ouput stages
     double k{0};                              // feedback factor in the loop
     double g;                                 // output gain. Calculated dynamically for TB_303 mode. Static value for other modes
     double gScale;                            // scaling factor for gain (to equalize filter mode output levels)
@@ -146,8 +231,46 @@ namespace rosic
     int    mode;                              // the selected filter-mode
     int    oldMode;                           // previous filter-mode
 
+    // TB_303_ZDF mode - the ladder is solved for the current sample with trapezoidal integrators. 
+    // The 4 stage equations form a tridiagonal system whose elimination factors depend only on 
+    // the cutoff, so per sample only the state-dependent part has to be eliminated:
+    double gz{0};                             // integrator gain (prewarped)
+    double cp1{0}, cp2{0}, cp3{0};            // elimination factors (upper diagonal)
+    double im1{1}, im2{1}, im3{1}, im4{1};    // reciprocal pivots
+    double q1{0}, q2{0}, q3{0}, q4{0};        // response of the eliminated system to the input
+    double ah{1};                             // feedback highpass: 1/(1+gain)
+    double ghAh{0};                           // feedback highpass: gain/(1+gain)
+    double feedbackRec{1};                    // 1/(1+ah*k*q4), for solving the feedback loop
+    double s1{0}, s2{0}, s3{0}, s4{0};        // integrator states
+    double sh{0};                             // feedback highpass state
+
+    // TB_303_NONLINEAR mode:
+    double x1{0}, x2{0}, x3{0}, x4{0};        // drives of the 4 stages (from the previous sample)
+
+    // coefficient ramp (setCutoffRamp) - increments of b0, a1, k, g and of the TB_303_ZDF 
+    // coefficients gz, cp1...cp3, im1...im4, q1...q4, feedbackRec:
+    static const int numRampedCoefficients = 17;
+    double rampIncrements[numRampedCoefficients];
+    int    rampSamples{0};                    // remaining steps of the ramp
+
     OnePoleFilter feedbackHighpass;
 
+    // the kernel for the current mode, one instantiation of getSampleForMode per mode:
+    typedef double (TeeBeeFilter::*SampleFunction)(double in);
+    SampleFunction sampleFunction;
+    static const SampleFunction sampleFunctions[NUM_MODES];
+
+    // cutoff modulation (applyCutoffFm) - each coefficient is fmBase + x*(fmSlope + x*fmCurve) 
+    // at a modulation of m octaves, with x = 2^m - 1 (only used with cutoff FM, so it comes after 
+    // the state that is used on every sample):
+    double fmDepth{0};                        // range of the modulation in octaves
+    double fmMinX{0}, fmMaxX{0};              // range of the modulation in the fit, as 2^m - 1
+    double fmSlope[numRampedCoefficients];
+    double fmCurve[numRampedCoefficients];
+    double fmBase[numRampedCoefficients];     // unmodulated coefficients
+    int    fmNumCoefficients{0};              // number of coefficients in the fit (0: no fit)
+    bool   fmValid{false};                    // the fit matches the coefficients in fmBase
+
   };
 
   //-----------------------------------------------------------------------------------------------
@@ -169,6 +292,123 @@ namespace rosic
       calculateCoefficientsApprox4();
   }
 
+  INLINE void TeeBeeFilter::setCutoffRamp(double newCutoff, int numSamples)
+  {
+    if( numSamples <= 1 )
+    {
+      setCutoff(newCutoff);
+      if( fmDepth > 0.0 )
+        fitCutoffFm();
+      return;
+    }
+    double start[numRampedCoefficients], target[numRampedCoefficients];
+    storeCoefficients(start);
+    setCutoff(newCutoff);
+    if( fmDepth > 0.0 )
+      fitCutoffFm();
+    int n = storeCoefficients(target);
+    double scaler = 1.0 / numSamples;
+    for(int i = 0; i < n; i++)
+      rampIncrements[i] = scaler * (target[i] - start[i]);
+
+    loadCoefficients(start);
+    rampSamples = numSamples;
+  }
+
+  INLINE void TeeBeeFilter::advanceCoefficients()
+  {
+    if( rampSamples <= 0 )
+      return;
+    const double* d = rampIncrements;
+    b0 += d[0]; a1 += d[1]; k += d[2]; g += d[3];
+    if( mode == TB_303_ZDF )
+    {
+      gz  += d[4];  cp1 += d[5];  cp2 += d[6];  cp3 += d[7];
+      im1 += d[8];  im2 += d[9];  im3 += d[10]; im4 += d[11];
+      q1  += d[12]; q2  += d[13]; q3  += d[14]; q4  += d[15];
+      feedbackRec += d[16];
+    }
+    rampSamples--;
+  }
+
+  INLINE void TeeBeeFilter::beginCutoffFm()
+  {
+    fmValid = (storeCoefficients(fmBase) == fmNumCoefficients);
+  }
+
+  INLINE void TeeBeeFilter::applyCutoffFm(double factor)
+  {
+    if( !fmValid )
+      return;
+    double x = clip(factor - 1.0, fmMinX, fmMaxX);
+    double c[numRampedCoefficients];
+    for(int i = 0; i < fmNumCoefficients; i++)
+      c[i] = fmBase[i] + x*(fmSlope[i] + x*fmCurve[i]);
+    loadCoefficients(c);
+  }
+
+  INLINE void TeeBeeFilter::endCutoffFm()
+  {
+    loadCoefficients(fmBase);
+  }
+
+  INLINE int TeeBeeFilter::storeCoefficients(double *c) const
+  {
+    c[0] = b0; c[1] = a1; c[2] = k; c[3] = g;
+    if( mode != TB_303_ZDF )
+      return 4;
+    c[4]  = gz;  c[5]  = cp1; c[6]  = cp2; c[7]  = cp3;
+    c[8]  = im1; c[9]  = im2; c[10] = im3; c[11] = im4;
+    c[12] = q1;  c[13] = q2;  c[14] = q3;  c[15] = q4;
+    c[16] = feedbackRec;
+    return numRampedCoefficients;
+  }
+
+  INLINE void TeeBeeFilter::loadCoefficients(const double *c)
+  {
+    b0 = c[0]; a1 = c[1]; k = c[2]; g = c[3];
+    if( mode == TB_303_ZDF )
+    {
+      gz  = c[4];  cp1 = c[5];  cp2 = c[6];  cp3 = c[7];
+      im1 = c[8];  im2 = c[9];  im3 = c[10]; im4 = c[11];
+      q1  = c[12]; q2  = c[13]; q3  = c[14]; q4  = c[15];
+      feedbackRec = c[16];
+    }
+  }
+
+  INLINE void TeeBeeFilter::fitCutoffFm()
+  {
+    // the coefficients at the cutoff and at +-fmDepth octaves around it (within the range of 
+    // setCutoff):
+    double center = cutoff;
+    double c0[numRampedCoefficients], up[numRampedCoefficients], down[numRampedCoefficients];
+    double factor = pow(2.0, fmDepth);
+    fmNumCoefficients = storeCoefficients(c0);
+    cutoff = clip(center*factor, 100.0, 20000.0);
+    calculateCoefficientsApprox4();
+    storeCoefficients(up);
+    cutoff = clip(center/factor, 100.0, 20000.0);
+    calculateCoefficientsApprox4();
+    storeCoefficients(down);
+    cutoff = center;
+    loadCoefficients(c0);
+
+    // the parabola through the three points, over the relative change of the cutoff 
+    // x = 2^m - 1 (which is zero at the cutoff) - the coefficients are smooth functions of the 
+    // cutoff, so they are much closer to a parabola over x than over m:
+    double xu = factor - 1.0;
+    double xd = 1.0/factor - 1.0;
+    fmMinX    = xd;
+    fmMaxX    = xu;
+    for(int i = 0; i < fmNumCoefficients; i++)
+    {
+      double du = (up[i]   - c0[i]) / xu;  // slopes of the secants
+      double dd = (down[i] - c0[i]) / xd;
+      fmCurve[i] = (du - dd) / (xu - xd);
+      fmSlope[i] = du - fmCurve[i]*xu;
+    }
+  }
+
   INLINE void TeeBeeFilter::setResonance(double newResonance, bool updateCoefficients)
   {
     // Check value is NaN, return early if yes
@@ -182,6 +422,8 @@ namespace rosic
 
   INLINE void TeeBeeFilter::calculateCoefficientsExact()
   {
+    rampSamples = 0;
+
     // calculate intermediate variables:
     double wc = twoPiOverSampleRate * cutoff;
     double s, c;
@@ -208,12 +450,47 @@ namespace rosic
     double gsq = b0*b0 / (1.0 + a1*a1 + 2.0*a1*c);
     k          = r / (gsq*gsq);
 
-    if( mode == TB_303 )
+    if( mode == TB_303 || mode == TB_303_NONLINEAR )
       k *= (17.0/4.0);
+    else if( mode == TB_303_ZDF )
+      calculateCoefficientsZdf();
+  }
+
+  INLINE void TeeBeeFilter::calculateCoefficientsZdf()
+  {
+    // The stages are integrators with gain wc/sqrt(2), where the analog ladder resonates at 
+    // sqrt(2) times the integrator gain and self-oscillates at a feedback factor of 17 - so 
+    // prewarping the integrators at the cutoff puts the resonance exactly there, at any 
+    // samplerate:
+    double wc = twoPiOverSampleRate * cutoff;
+    double r  = resonanceSkewed;
+    gz = tan(0.5*wc) * ONE_OVER_SQRT2;
+    k  = 17.0 * r;
+    g  = 1.0 + r;
+
+    // eliminate the lower diagonal of the stage equations (diagonal 1+2*gz, off-diagonals -gz, 
+    // except -2*gz in the 1st row):
+    im1 = 1.0 / (1.0 + 2.0*gz);
+    cp1 = -2.0*gz * im1;
+    im2 = 1.0 / (1.0 + 2.0*gz + gz*cp1);
+    cp2 = -gz * im2;
+    im3 = 1.0 / (1.0 + 2.0*gz + gz*cp2);
+    cp3 = -gz * im3;
+    im4 = 1.0 / (1.0 + 2.0*gz + gz*cp3);
+
+    // response to the ladder input y0, which enters the 1st stage with 2*gz:
+    q1 = 2.0*gz * im1;
+    q2 = gz * q1 * im2;
+    q3 = gz * q2 * im3;
+    q4 = gz * q3 * im4;
+
+    feedbackRec = 1.0 / (1.0 + ah*k*q4);
   }
 
   INLINE void TeeBeeFilter::calculateCoefficientsApprox4()
   {
+    rampSamples = 0;
+
     // calculate intermediate variables:
     double wc  = twoPiOverSampleRate * cutoff;
     double wc2 = wc*wc;
@@ -262,7 +539,7 @@ namespace rosic
     k    = r * tmp;
     //g    = 8.0;
 
-    if( mode == TB_303 )
+    if( mode == TB_303 || mode == TB_303_NONLINEAR )
     {
       double fx = wc * ONE_OVER_SQRT2/(2*PI); 
       b0 = (0.00045522346 + 6.1922189 * fx) / (1.0 + 12.358354 * fx + 4.4156345 * (fx * fx)); 
@@ -272,28 +549,55 @@ namespace rosic
       g  = (g * (1.0 + r)); 
       k  = k * r;                                   // k is ready now 
     }
+    else if( mode == TB_303_ZDF )
+      calculateCoefficientsZdf();
 
   }
 
-  // INLINE double TeeBeeFilter::shape(double x)
-  // {
-  //   // return tanhApprox(x); // \todo: find some more suitable nonlinearity here
-  //   //return x; // test
+  INLINE double TeeBeeFilter::shapeGain(double x)
+  {
+    // tanhApprox(x)/x, saturating at the peak level of the oscillator:
+    double a = fabs(2*x);
+    double b = 24+a*(12+a*(6+a));
+    return 2*b/(a*b+48);
+  }
 
-  //   const double r6 = 1.0/6.0;
-  //   x = clip(x, -SQRT2, SQRT2);
-  //   return x - r6*x*x*x;
+  template<int M>
+  INLINE double TeeBeeFilter::getSampleForMode(double in)
+  {
+    if constexpr( M == TB_303_ZDF )
+    {
+      // eliminate the state-dependent part (the y0-dependent part is in q1...q4):
+      double p1 = s1 * im1;
+      double p2 = (s2 + gz*p1) * im2;
+      double p3 = (s3 + gz*p2) * im3;
+      double p4 = (s4 + gz*p3) * im4;
+
+      // solve y0 = in - hp(k*y4) with y4 = p4 + q4*y0 and hp(x) = ah*(x-sh):
+      double u = (in + ah*(sh - k*p4)) * feedbackRec;
+
+      // back substitution:
+      y4 = p4 + q4*u;
+      y3 = p3 + q3*u - cp3*y4;
+      y2 = p2 + q2*u - cp2*y3;
+      y1 = p1 + q1*u - cp1*y2;
+
+      // update the states:
+      s1  = 2*y1 - s1;
+      s2  = 2*y2 - s2;
+      s3  = 2*y3 - s3;
+      s4  = 2*y4 - s4;
+      double v = ghAh * (k*y4 - sh);
+      sh += 2*v;
 
-  //   //return clip(x, -1.0, 1.0);
-  // }
+      return 2*g*y4;
+    }
 
-  INLINE double TeeBeeFilter::getSample(double in)
-  {
     // Process input through highpass
     double y0 = in - feedbackHighpass.getSample(k*y4); 
 
     // 303 filter mode has different filter
-    if( mode == TB_303 )
+    if constexpr( M == TB_303 )
     {
       y1 += 2*b0*(y0-y1+y2);
       y2 +=   b0*(y1-2*y2+y3);
@@ -303,6 +607,20 @@ namespace rosic
       return 2*g*y4;
     }
 
+    // the same ladder, with the drive into each stage saturating like a transistor pair. The
+    // saturation is applied as a gain taken from each stage's drive of the previous sample: the 4
+    // gains don't depend on each other (so they are evaluated in parallel, off the serial path 
+    // through the ladder) and never exceed 1, so the ladder stays as stable as the linear one:
+    if constexpr( M == TB_303_NONLINEAR )
+    {
+      double sg1 = shapeGain(x1), sg2 = shapeGain(x2), sg3 = shapeGain(x3), sg4 = shapeGain(x4);
+      x1 = y0-y1+y2;    y1 += 2*b0*sg1*x1;
+      x2 = y1-2*y2+y3;  y2 +=   b0*sg2*x2;
+      x3 = y2-2*y3+y4;  y3 +=   b0*sg3*x3;
+      x4 = y3-2*y4;     y4 +=   b0*sg4*x4;
+      return 2*g*y4;
+    }
+
     // apply drive and feedback to obtain the filter's input signal:
     //y0 = 0.125*driveFactor*in - feedbackHighpass.getSample(k*y4); 
     
@@ -312,11 +630,17 @@ namespace rosic
     y1 = y0 + a1*(y0-y1);
     y2 = y1 + a1*(y1-y2);
     y3 = y2 + a1*(y2-y3);
-    y4 = y3 + a1*(y3-y4); // \todo: performance test both versions of the ladder
-    //y4 = shape(y3 + a1*(y3-y4)); // \todo: performance test both versions of the ladder
-
-    // Combine poles
-    return g * (c0*y0 + c1*y1 + c2*y2 + c3*y3 + c4*y4);
+    y4 = y3 + a1*(y3-y4);
+
+    // Combine poles (the zero taps are dropped at compile time):
+    constexpr const double* c = poleMix[M];
+    double out = 0.0;
+    if constexpr( c[0] != 0.0 ) out += c[0]*y0;
+    if constexpr( c[1] != 0.0 ) out += c[1]*y1;
+    if constexpr( c[2] != 0.0 ) out += c[2]*y2;
+    if constexpr( c[3] != 0.0 ) out += c[3]*y3;
+    if constexpr( c[4] != 0.0 ) out += c[4]*y4;
+    return g * out;
   }
 
 }
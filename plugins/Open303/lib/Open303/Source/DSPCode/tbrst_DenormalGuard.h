@@ -0,0 +1,126 @@
+#ifndef rosic_DenormalGuard_h
+#define rosic_DenormalGuard_h
+
+// rosic-indcludes:
+#include "GlobalDefinitions.h"
+
+// the floating point control register with the flush-to-zero (and denormals-are-zero) bits:
+#if defined(__SSE__) || defined(__x86_64__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+  #define OPEN303_DENORMAL_GUARD_SSE
+  #include <xmmintrin.h>
+#elif defined(__aarch64__) && defined(__GNUC__)
+  #define OPEN303_DENORMAL_GUARD_AARCH64
+#elif defined(__arm__) && defined(__ARM_FP) && defined(__GNUC__)
+  #define OPEN303_DENORMAL_GUARD_ARM
+#endif
+
+// Some filters add TINY to their input or state to keep it out of the denormal range. Builds that
+// run the processing under a DenormalGuard (OPEN303_FLUSH_DENORMALS) leave that out where the 
+// guard works:
+#if defined(OPEN303_FLUSH_DENORMALS) && (defined(OPEN303_DENORMAL_GUARD_SSE) \
+  || defined(OPEN303_DENORMAL_GUARD_AARCH64) || defined(OPEN303_DENORMAL_GUARD_ARM))
+  #define ANTI_DENORMAL(x) (x)
+#else
+  #define ANTI_DENORMAL(x) ((x) + TINY)
+#endif
+
+namespace rosic
+{
+
+  /**
+
+  Flushes denormal numbers to zero for as long as it exists, on the thread that created it: the 
+  constructor sets the flush-to-zero and denormals-are-zero bits of MXCSR on x86 (the flush-to-zero
+  bit of FPCR/FPSCR on ARM) and the destructor restores the previous setting. Denormals show up when
+  filter states and envelopes decay towards zero (e.g. in release tails) and are very slow on x86, 
+  so the audio processing is wrapped into one of these:
+
+  {
+    DenormalGuard guard;
+    ...process...
+  }
+
+  On other platforms, it does nothing (and isSupported is false).
+
+  */
+
+  class DenormalGuard
+  {
+
+  public:
+
+#if defined(OPEN303_DENORMAL_GUARD_SSE)
+    typedef unsigned int Mode;
+    static const Mode flushBits = 0x8040; // flush-to-zero, denormals-are-zero
+#elif defined(OPEN303_DENORMAL_GUARD_AARCH64)
+    typedef UINT64 Mode;
+    static const Mode flushBits = 1 << 24;
+#elif defined(OPEN303_DENORMAL_GUARD_ARM)
+    typedef unsigned int Mode;
+    static const Mode flushBits = 1 << 24;
+#else
+    typedef unsigned int Mode;
+    static const Mode flushBits = 0;
+#endif
+
+    /** True if the guard can flush denormals on this platform. */
+    static const bool isSupported = flushBits != 0;
+
+    /** Constructor. Switches denormal flushing on. */
+    DenormalGuard() : previousMode(getMode())
+    {
+      if( (previousMode & flushBits) != flushBits )
+        setMode(previousMode | flushBits);
+    }
+
+    /** Destructor. Restores the previous mode. */
+    ~DenormalGuard()
+    {
+      if( (previousMode & flushBits) != flushBits )
+        setMode(previousMode);
+    }
+
+    DenormalGuard(const DenormalGuard&) = delete;
+    DenormalGuard& operator=(const DenormalGuard&) = delete;
+
+    /** Returns the current content of the floating point control register. */
+    static INLINE Mode getMode()
+    {
+#if defined(OPEN303_DENORMAL_GUARD_SSE)
+      return _mm_getcsr();
+#elif defined(OPEN303_DENORMAL_GUARD_AARCH64)
+      Mode mode;
+      __asm__ __volatile__("mrs %0, fpcr" : "=r"(mode));
+      return mode;
+#elif defined(OPEN303_DENORMAL_GUARD_ARM)
+      Mode mode;
+      __asm__ __volatile__("vmrs %0, fpscr" : "=r"(mode));
+      return mode;
+#else
+      return 0;
+#endif
+    }
+
+    /** Sets the floating point control register. */
+    static INLINE void setMode(Mode mode)
+    {
+#if defined(OPEN303_DENORMAL_GUARD_SSE)
+      _mm_setcsr(mode);
+#elif defined(OPEN303_DENORMAL_GUARD_AARCH64)
+      __asm__ __volatile__("msr fpcr, %0" : : "r"(mode));
+#elif defined(OPEN303_DENORMAL_GUARD_ARM)
+      __asm__ __volatile__("vmsr fpscr, %0" : : "r"(mode));
+#else
+      (void) mode;
+#endif
+    }
+
+  protected:
+
+    Mode previousMode;
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_DenormalGuard_h
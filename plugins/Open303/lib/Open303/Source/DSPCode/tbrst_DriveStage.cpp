@@ -0,0 +1,149 @@
+// rosic-includes:
+#include "tbrst_DriveStage.h"
+
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// antiderivative tables:
+
+const double AntiderivativeTable::spacing    = 2.0 * range / numIntervals;
+const double AntiderivativeTable::spacingRec = numIntervals / (2.0 * range);
+
+AntiderivativeTable::AntiderivativeTable(int shaperMode)
+{
+  const int    center = numIntervals/2; // grid point at x = 0
+  const double h      = spacing;
+
+  int i;
+  for(i=0; i<=numIntervals; i++)
+  {
+    double x = (i-center) * h;
+    f[i]     = DriveStage::shape(shaperMode, x);
+    F1[i]    = DriveStage::firstAntiderivative(shaperMode, x);
+  }
+
+  // integrate F1 outward from x = 0 with the end-corrected trapezoidal rule (the corrections use 
+  // the derivative of F1, which is the shaper itself):
+  F2[center] = 0.0;
+  for(i=center; i<numIntervals; i++)
+    F2[i+1] = F2[i] + 0.5*h*(F1[i]+F1[i+1]) + h*h/12.0*(f[i]-f[i+1]);
+  for(i=center; i>0; i--)
+    F2[i-1] = F2[i] - 0.5*h*(F1[i-1]+F1[i]) - h*h/12.0*(f[i-1]-f[i]);
+}
+
+// built when the library is loaded, so no DriveStage has to build them on the audio thread:
+static const AntiderivativeTable softTable(DriveStage::SOFT);
+static const AntiderivativeTable hardTable(DriveStage::HARD);
+static const AntiderivativeTable asymmetricTable(DriveStage::ASYMMETRIC);
+static const AntiderivativeTable tanhTable(DriveStage::TANH);
+
+const AntiderivativeTable* AntiderivativeTable::getTable(int shaperMode)
+{
+  switch( shaperMode )
+  {
+  case DriveStage::SOFT:       return &softTable;
+  case DriveStage::HARD:       return &hardTable;
+  case DriveStage::ASYMMETRIC: return &asymmetricTable;
+  case DriveStage::TANH:       return &tanhTable;
+  default:                     return NULL;
+  }
+}
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+const double DriveStage::epsilon = 1.e-5;
+
+DriveStage::DriveStage()
+{
+  mode         = BYPASS;
+  antiAliasing = NO_ANTI_ALIASING;
+  table        = NULL;
+  drive        = 0.0;
+  driveFactor  = 1.0;
+  makeUpGain   = 1.0;
+  toneFilter.setMode(OnePoleFilter::LOWPASS);
+  toneFilter.setCutoff(20000.0);
+  reset();
+}
+
+DriveStage::~DriveStage()
+{
+
+}
+
+//-------------------------------------------------------------------------------------------------
+// parameter settings:
+
+void DriveStage::setMode(int newMode)
+{
+  if( newMode < 0 || newMode >= NUM_MODES || newMode == mode )
+    return;
+  mode  = newMode;
+  table = AntiderivativeTable::getTable(mode);
+  updateAntiAliasingState();
+}
+
+void DriveStage::setAntiAliasing(int newMethod)
+{
+  if( newMethod < 0 || newMethod >= NUM_ANTI_ALIASING_METHODS || newMethod == antiAliasing )
+    return;
+  antiAliasing = newMethod;
+  updateAntiAliasingState();
+}
+
+void DriveStage::setDrive(double newDrive)
+{
+  drive       = newDrive;
+  driveFactor = dB2amp(drive);
+  makeUpGain  = dB2amp(-0.5*drive);
+}
+
+//-------------------------------------------------------------------------------------------------
+// inquiry:
+
+double DriveStage::firstAntiderivative(int mode, double x)
+{
+  double a = fabs(x);
+  switch( mode )
+  {
+  case SOFT:
+    if( a <= 0.5 )
+      return 0.5*x*x;
+    return a - 0.25*log(2.0*a) - 0.375;
+  case HARD:
+    if( a <= 1.0 )
+      return 0.5*x*x;
+    return a - 0.5;
+  case ASYMMETRIC:
+    if( x >= 0.0 )
+      return x - log(1.0 + x);
+    return -2.0*x - 4.0*log(1.0 - 0.5*x);
+  case TANH:
+    return a + log(1.0 + exp(-2.0*a)) - log(2.0); // log(cosh(x)) without overflow
+  default:
+    return 0.5*x*x;
+  }
+}
+
+//-------------------------------------------------------------------------------------------------
+// others:
+
+void DriveStage::updateAntiAliasingState()
+{
+  if( table == NULL )
+    return;
+  F1x1 = table->getFirst(x1);
+  F2x1 = table->getSecond(x1);
+  if( fabs(x1 - x2) > epsilon )
+    D1x1 = (F2x1 - table->getSecond(x2)) / (x1 - x2);
+  else
+    D1x1 = table->getFirst(0.5*(x1 + x2));
+}
+
+void DriveStage::reset()
+{
+  toneFilter.reset();
+  x1   = x2 = 0.0;
+  F1x1 = F2x1 = D1x1 = 0.0;
+}
@@ -0,0 +1,311 @@
+#ifndef rosic_DriveStage_h
+#define rosic_DriveStage_h
+
+// standard-library includes:
+#include <math.h>
+
+// rosic-indcludes:
+#include "rosic_OnePoleFilter.h"
+
+namespace rosic
+{
+
+  /**
+
+  Tables of the first and second antiderivative of one of the DriveStage shapers, for 
+  antiderivative anti-aliasing (ADAA). The antiderivatives are tabulated on a uniform grid over 
+  -range...+range (together with the shaper function itself, which is the derivative of the first 
+  antiderivative) and read with cubic Hermite interpolation. Outside the range, they are 
+  continued as if the shaper were constant, which is exact for the clippers and tanh and close 
+  for the others. One table per shaper is built when the library is loaded.
+
+  */
+
+  class AntiderivativeTable
+  {
+
+  public:
+
+    /** Number of grid intervals over -range...+range. */
+    static const int numIntervals = 4096;
+
+    /** The grid covers inputs (after the drive gain) from -range to +range. */
+    static const int range = 32;
+
+    /** Constructor. Tabulates the antiderivatives of the given DriveStage shaper. */
+    AntiderivativeTable(int shaperMode);
+
+    /** Returns the table for one of the DriveStage shapers (NULL for BYPASS). */
+    static const AntiderivativeTable* getTable(int shaperMode);
+
+    /** Returns the first antiderivative of the shaper at x. */
+    INLINE double getFirst(double x) const;
+
+    /** Returns the second antiderivative of the shaper at x. */
+    INLINE double getSecond(double x) const;
+
+  protected:
+
+    /** Cubic Hermite interpolation between y0 and y1 with slopes d0 and d1 (per grid step). */
+    static INLINE double hermite(double y0, double y1, double d0, double d1, double u);
+
+    static const double spacing;   // grid spacing
+    static const double spacingRec;
+
+    double f [numIntervals+1]; // shaper
+    double F1[numIntervals+1]; // first antiderivative
+    double F2[numIntervals+1]; // second antiderivative
+
+  };
+
+  /**
+
+  This is a waveshaping distortion with a gain in front of the shaper and a one-pole lowpass 
+  'tone' filter behind it. It is meant to run inside the oversampled loop of Open303 (between the 
+  303 filter and the anti-aliasing filter), so the harmonics generated by the shaper are removed 
+  by the decimation filter instead of folding back into the audio band. When it runs at the base 
+  rate instead, the shaper can be evaluated with 1st or 2nd order antiderivative anti-aliasing 
+  (ADAA) to suppress most of the aliasing. ADAA delays the signal by half a sample (1st order) or 
+  one sample (2nd order).
+
+  */
+
+  class DriveStage
+  {
+
+  public:
+
+    /** The available shaper types. */
+    enum modes
+    {
+      BYPASS = 0,
+      SOFT,        // soft clipper (as sclang's softclip), linear up to 0.5, saturates at 1
+      HARD,        // hard clipper at -1...+1
+      ASYMMETRIC,  // rational saturation that is twice as soft for negative values (even harmonics)
+      TANH,        // hyperbolic tangent
+
+      NUM_MODES
+    };
+
+    /** The available methods to evaluate the shaper. */
+    enum antiAliasingMethods
+    {
+      NO_ANTI_ALIASING = 0,
+      ADAA1,                // 1st order antiderivative anti-aliasing
+      ADAA2,                // 2nd order antiderivative anti-aliasing
+
+      NUM_ANTI_ALIASING_METHODS
+    };
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    DriveStage();
+
+    /** Destructor. */
+    ~DriveStage();
+
+    //---------------------------------------------------------------------------------------------
+    // parameter settings:
+
+    /** Sets the sample-rate (in Hz) at which the stage runs. */
+    void setSampleRate(double newSampleRate) { toneFilter.setSampleRate(newSampleRate); }
+
+    /** Selects one of the modes (@see modes). */
+    void setMode(int newMode);
+
+    /** Selects the method for evaluating the shaper (@see antiAliasingMethods). */
+    void setAntiAliasing(int newMethod);
+
+    /** Sets the gain in front of the shaper in decibels. Half of it is taken off again behind the 
+    shaper, as rough compensation for the loudness increase of the clipped signal. */
+    void setDrive(double newDrive);
+
+    /** Sets the cutoff frequency of the tone filter (in Hz). */
+    void setTone(double newTone) { toneFilter.setCutoff(newTone); }
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns the mode (@see modes). */
+    int getMode() const { return mode; }
+
+    /** Returns the method for evaluating the shaper (@see antiAliasingMethods). */
+    int getAntiAliasing() const { return antiAliasing; }
+
+    /** Returns the gain in front of the shaper in decibels. */
+    double getDrive() const { return drive; }
+
+    /** Returns the cutoff frequency of the tone filter (in Hz). */
+    double getTone() const { return toneFilter.getCutoff(); }
+
+    /** Returns the output of one of the shapers for input x. */
+    static INLINE double shape(int mode, double x);
+
+    /** Returns the first antiderivative (zero at x=0) of one of the shapers, in closed form. Used 
+    to build the AntiderivativeTable. */
+    static double firstAntiderivative(int mode, double x);
+
+    //---------------------------------------------------------------------------------------------
+    // audio processing:
+
+    /** Calculates one sample at a time. */
+    INLINE double getSample(double in);
+
+    //---------------------------------------------------------------------------------------------
+    // others:
+
+    /** Resets the tone filter's and the anti-aliasing state. */
+    void reset();
+
+  protected:
+
+    /** Shaper output for input x with 1st and 2nd order ADAA. */
+    INLINE double getShapedAdaa1(double x);
+    INLINE double getShapedAdaa2(double x);
+
+    /** Recomputes the antiderivatives of the past inputs (after the shaper has changed). */
+    void updateAntiAliasingState();
+
+    static const double epsilon; // below this input difference, ADAA falls back to the shaper
+
+    OnePoleFilter toneFilter;
+    const AntiderivativeTable *table; // antiderivatives of the current shaper
+    double drive;       // gain in front of the shaper in dB
+    double driveFactor; // same as raw factor
+    double makeUpGain;  // level compensation behind the shaper
+    double x1, x2;      // past shaper inputs
+    double F1x1;        // first antiderivative at x1 (for ADAA1)
+    double F2x1;        // second antiderivative at x1 (for ADAA2)
+    double D1x1;        // divided difference of F2 between x2 and x1 (for ADAA2)
+    int    mode;
+    int    antiAliasing;
+
+  };
+
+  //-----------------------------------------------------------------------------------------------
+  // inlined functions:
+
+  INLINE double AntiderivativeTable::hermite(double y0, double y1, double d0, double d1, double u)
+  {
+    double c = 3.0*(y1-y0) - 2.0*d0 - d1;
+    double d = 2.0*(y0-y1) + d0 + d1;
+    return y0 + u*(d0 + u*(c + u*d));
+  }
+
+  INLINE double AntiderivativeTable::getFirst(double x) const
+  {
+    double t = (x + range) * spacingRec;
+    if( t < 0.0 )
+      return F1[0] + f[0] * (x + range);
+    if( t >= numIntervals )
+      return F1[numIntervals] + f[numIntervals] * (x - range);
+    int    i = (int) t;
+    double u = t - i;
+    return hermite(F1[i], F1[i+1], spacing*f[i], spacing*f[i+1], u);
+  }
+
+  INLINE double AntiderivativeTable::getSecond(double x) const
+  {
+    double t = (x + range) * spacingRec;
+    if( t < 0.0 )
+    {
+      double d = x + range;
+      return F2[0] + d * (F1[0] + 0.5 * d * f[0]);
+    }
+    if( t >= numIntervals )
+    {
+      double d = x - range;
+      return F2[numIntervals] + d * (F1[numIntervals] + 0.5 * d * f[numIntervals]);
+    }
+    int    i = (int) t;
+    double u = t - i;
+    return hermite(F2[i], F2[i+1], spacing*F1[i], spacing*F1[i+1], u);
+  }
+
+  INLINE double DriveStage::shape(int mode, double x)
+  {
+    switch( mode )
+    {
+    case SOFT:
+      {
+        double a = fabs(x);
+        return (a <= 0.5) ? x : (a - 0.25) / x;
+      }
+    case HARD:
+      return (x > 1.0) ? 1.0 : ((x < -1.0) ? -1.0 : x);
+    case ASYMMETRIC:
+      return (x >= 0.0) ? x / (1.0 + x) : x / (1.0 - 0.5*x);
+    case TANH:
+      return tanh(x);
+    default:
+      return x;
+    }
+  }
+
+  INLINE double DriveStage::getShapedAdaa1(double x)
+  {
+    double F1x = table->getFirst(x);
+    double d   = x - x1;
+    double y;
+    if( fabs(d) > epsilon )
+      y = (F1x - F1x1) / d;
+    else
+      y = shape(mode, 0.5*(x + x1));
+    x1   = x;
+    F1x1 = F1x;
+    return y;
+  }
+
+  INLINE double DriveStage::getShapedAdaa2(double x)
+  {
+    double F2x = table->getSecond(x);
+    double d   = x - x1;
+    double D1x;
+    if( fabs(d) > epsilon )
+      D1x = (F2x - F2x1) / d;
+    else
+      D1x = table->getFirst(0.5*(x + x1));
+
+    double y;
+    double d2 = x - x2;
+    if( fabs(d2) > epsilon )
+      y = 2.0 * (D1x - D1x1) / d2;
+    else
+    {
+      // x and x2 (nearly) coincide - use the midpoint between them:
+      double xm    = 0.5*(x + x2);
+      double delta = xm - x1;
+      if( fabs(delta) > epsilon )
+        y = 2.0/delta * (table->getFirst(xm) + (F2x1 - table->getSecond(xm)) / delta);
+      else
+        y = shape(mode, 0.5*(xm + x1));
+    }
+
+    x2   = x1;
+    x1   = x;
+    F2x1 = F2x;
+    D1x1 = D1x;
+    return y;
+  }
+
+  INLINE double DriveStage::getSample(double in)
+  {
+    if( mode == BYPASS )
+      return in;
+
+    double x = driveFactor * in;
+    double y;
+    switch( antiAliasing )
+    {
+    case ADAA1: y = getShapedAdaa1(x); break;
+    case ADAA2: y = getShapedAdaa2(x); break;
+    default:    y = shape(mode, x);
+    }
+    return toneFilter.getSample(makeUpGain * y);
+  }
+
+}
+
+#endif
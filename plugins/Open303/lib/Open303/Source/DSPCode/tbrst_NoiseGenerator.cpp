@@ -0,0 +1,46 @@
+// rosic-includes:
+#include "tbrst_NoiseGenerator.h"
+
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+NoiseGenerator::NoiseGenerator()
+{
+  mode      = WHITE;
+  holdRatio = 8.0;
+  setSeed(0);
+  reset();
+}
+
+NoiseGenerator::~NoiseGenerator()
+{
+
+}
+
+//-------------------------------------------------------------------------------------------------
+// parameter settings:
+
+void NoiseGenerator::setSeed(unsigned int newSeed)
+{
+  // derive the lane states with the splitmix32 finalizer, so that similar seeds still give 
+  // unrelated sequences:
+  for(int k=0; k<numLanes; k++)
+  {
+    unsigned int x = newSeed + 0x9E3779B9u * (k+1);
+    x = (x ^ (x >> 16)) * 0x85EBCA6Bu;
+    x = (x ^ (x >> 13)) * 0xC2B2AE35u;
+    x =  x ^ (x >> 16);
+    state[k] = (x != 0) ? x : 0x6D2B79F5u; // xorshift must not start at zero
+  }
+}
+
+//-------------------------------------------------------------------------------------------------
+// others:
+
+void NoiseGenerator::reset()
+{
+  holdPhase = 0.0;
+  holdValue = 0.0;
+}
@@ -0,0 +1,151 @@
+#ifndef rosic_NoiseGenerator_h
+#define rosic_NoiseGenerator_h
+
+// standard-library includes:
+#include <math.h>
+
+// rosic-indcludes:
+#include "GlobalDefinitions.h"
+
+namespace rosic
+{
+
+  /**
+
+  This is a noise generator that produces uniformly distributed values between -1 and +1, either
+  as white noise or as sample-and-hold noise whose hold rate is a multiple of an oscillator's
+  frequency (so it follows the pitch, including slides). The values come from numLanes
+  independent xorshift generators that are advanced side by side, so the compiler can turn the
+  inner loop of generateBlock() into SIMD code. It is meant to run inside the oversampled loop of
+  Open303, producing one block of 'oversampling' values per output sample.
+
+  */
+
+  class NoiseGenerator
+  {
+
+  public:
+
+    /** The available noise types. */
+    enum modes
+    {
+      WHITE = 0,
+      SAMPLE_AND_HOLD,
+
+      NUM_MODES
+    };
+
+    /** Number of independent generators - blocks are produced in multiples of this. */
+    static const int numLanes = 4;
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    NoiseGenerator();
+
+    /** Destructor. */
+    ~NoiseGenerator();
+
+    //---------------------------------------------------------------------------------------------
+    // parameter settings:
+
+    /** Selects one of the modes (@see modes). */
+    void setMode(int newMode) { if( newMode >= 0 && newMode < NUM_MODES ) mode = newMode; }
+
+    /** Sets the hold rate of the SAMPLE_AND_HOLD mode as multiple of the oscillator frequency. */
+    void setHoldRatio(double newRatio) { if( newRatio > 0.0 ) holdRatio = newRatio; }
+
+    /** Seeds the generators. Different seeds give different (uncorrelated) sequences. */
+    void setSeed(unsigned int newSeed);
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns the mode (@see modes). */
+    int getMode() const { return mode; }
+
+    /** Returns the hold rate of the SAMPLE_AND_HOLD mode as multiple of the oscillator 
+    frequency. */
+    double getHoldRatio() const { return holdRatio; }
+
+    //---------------------------------------------------------------------------------------------
+    // audio processing:
+
+    /** Fills 'buffer' with 'length' white noise values, 'length' must be a multiple of 
+    numLanes. */
+    INLINE void generateBlock(double *buffer, int length);
+
+    /** Produces 'length' output samples (a multiple of numLanes) according to the mode. 
+    'cycleIncrement' is the oscillator's phase increment per sample in cycles, it determines the 
+    hold rate of the SAMPLE_AND_HOLD mode. */
+    INLINE void getSamples(double *buffer, int length, double cycleIncrement);
+
+    //---------------------------------------------------------------------------------------------
+    // others:
+
+    /** Resets the sample-and-hold state. */
+    void reset();
+
+  protected:
+
+    unsigned int state[numLanes]; // xorshift states (never zero)
+    double holdPhase;             // phase of the sample-and-hold clock (in cycles)
+    double holdValue;             // currently held value
+    double holdRatio;             // hold rate as multiple of the oscillator frequency
+    int    mode;
+
+  };
+
+  //-----------------------------------------------------------------------------------------------
+  // inlined functions:
+
+  INLINE void NoiseGenerator::generateBlock(double *buffer, int length)
+  {
+    const double scaler = 1.0 / 2147483648.0;
+
+    // work on a local copy of the states, so the compiler knows they don't alias the buffer:
+    unsigned int s[numLanes];
+    for(int k=0; k<numLanes; k++)
+      s[k] = state[k];
+
+    for(int n=0; n<length; n+=numLanes)
+    {
+      for(int k=0; k<numLanes; k++) // independent lanes - vectorizes
+      {
+        unsigned int x = s[k];
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        s[k]        = x;
+        buffer[n+k] = scaler * (int) x;
+      }
+    }
+
+    for(int k=0; k<numLanes; k++)
+      state[k] = s[k];
+  }
+
+  INLINE void NoiseGenerator::getSamples(double *buffer, int length, double cycleIncrement)
+  {
+    generateBlock(buffer, length);
+    if( mode == WHITE )
+      return;
+
+    // sample-and-hold - latch a new value whenever the clock wraps around:
+    double increment = holdRatio * cycleIncrement;
+    for(int n=0; n<length; n++)
+    {
+      holdPhase += increment;
+      if( holdPhase >= 1.0 )
+      {
+        holdPhase -= floor(holdPhase);
+        holdValue  = buffer[n];
+      }
+      buffer[n] = holdValue;
+    }
+  }
+
+}
+
+#endif
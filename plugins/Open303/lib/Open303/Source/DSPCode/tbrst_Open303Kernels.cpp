@@ -0,0 +1,141 @@
+// rosic-includes:
+#include "tbrst_Open303Kernels.h"
+#include "rosic_Open303.h"
+
+using namespace rosic;
+
+// Variants besides the generic one need the target attribute of GCC and Clang, and a way to ask 
+// the CPU for its features - __builtin_cpu_supports on x86 (which also checks that the operating 
+// system saves the AVX registers), the hardware capabilities of the kernel on 32-bit ARM Linux:
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  #define OPEN303_KERNELS_X86
+#elif defined(__GNUC__) && defined(__arm__) && defined(__linux__) && !defined(__ARM_NEON)
+  #define OPEN303_KERNELS_ARM_NEON
+  #include <sys/auxv.h>
+  #include <asm/hwcap.h>
+#endif
+
+// flatten inlines everything the kernel calls (as far as the definitions are visible), so the 
+// inlined code is compiled for the target of the kernel while the out-of-line copies of the 
+// inline functions - which the linker may share with other translation units - stay generic:
+#if defined(__GNUC__)
+  #define OPEN303_KERNEL __attribute__((flatten))
+  #define OPEN303_KERNEL_TARGET(isa) __attribute__((flatten, target(isa)))
+#else
+  #define OPEN303_KERNEL
+#endif
+
+// Defines the render and finish kernels for one instruction set:
+#define OPEN303_DEFINE_KERNELS(suffix, attributes)                                               \
+  static attributes void render##suffix(Open303 &o303, int numSamples)                          \
+  {                                                                                             \
+    o303.renderSamples(numSamples);                                                             \
+  }                                                                                             \
+  static attributes void finish##suffix(Open303 &o303, float *out)                              \
+  {                                                                                             \
+    o303.finishBlock(out);                                                                      \
+  }
+
+OPEN303_DEFINE_KERNELS(Generic, OPEN303_KERNEL)
+
+#ifdef OPEN303_KERNELS_X86
+OPEN303_DEFINE_KERNELS(Avx2,   OPEN303_KERNEL_TARGET("avx2,fma"))
+OPEN303_DEFINE_KERNELS(Avx512, OPEN303_KERNEL_TARGET("avx512f,avx512vl,avx512dq,avx512bw,avx2,fma"))
+#endif
+
+#ifdef OPEN303_KERNELS_ARM_NEON
+OPEN303_DEFINE_KERNELS(Neon,   OPEN303_KERNEL_TARGET("fpu=neon"))
+#endif
+
+Open303Kernels::RenderFunction Open303Kernels::renderFunction = renderGeneric;
+Open303Kernels::FinishFunction Open303Kernels::finishFunction = finishGeneric;
+int                            Open303Kernels::selected       = GENERIC;
+
+//-------------------------------------------------------------------------------------------------
+// inquiry:
+
+bool Open303Kernels::isCompiled(int instructionSet)
+{
+  switch( instructionSet )
+  {
+  case GENERIC: return true;
+#ifdef OPEN303_KERNELS_X86
+  case AVX2:    return true;
+  case AVX512:  return true;
+#endif
+#ifdef OPEN303_KERNELS_ARM_NEON
+  case NEON:    return true;
+#endif
+  default:      return false;
+  }
+}
+
+bool Open303Kernels::isSupported(int instructionSet)
+{
+  if( !isCompiled(instructionSet) )
+    return false;
+
+  switch( instructionSet )
+  {
+#ifdef OPEN303_KERNELS_X86
+  case AVX2:
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  case AVX512:
+    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl")
+      && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512bw")
+      && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+#ifdef OPEN303_KERNELS_ARM_NEON
+  case NEON:
+    return (getauxval(AT_HWCAP) & HWCAP_NEON) != 0;
+#endif
+  default:
+    return true; // GENERIC
+  }
+}
+
+int Open303Kernels::detectInstructionSet()
+{
+  const int preferred[] = { AVX512, AVX2, NEON };
+  for(int instructionSet : preferred)
+  {
+    if( isSupported(instructionSet) )
+      return instructionSet;
+  }
+  return GENERIC;
+}
+
+const char* Open303Kernels::getName(int instructionSet)
+{
+  switch( instructionSet )
+  {
+  case GENERIC: return "generic";
+  case AVX2:    return "AVX2";
+  case AVX512:  return "AVX-512";
+  case NEON:    return "NEON";
+  default:      return "unknown";
+  }
+}
+
+//-------------------------------------------------------------------------------------------------
+// setup:
+
+bool Open303Kernels::select(int instructionSet)
+{
+  if( !isSupported(instructionSet) )
+    return false;
+
+  switch( instructionSet )
+  {
+#ifdef OPEN303_KERNELS_X86
+  case AVX2:   renderFunction = renderAvx2;   finishFunction = finishAvx2;   break;
+  case AVX512: renderFunction = renderAvx512; finishFunction = finishAvx512; break;
+#endif
+#ifdef OPEN303_KERNELS_ARM_NEON
+  case NEON:   renderFunction = renderNeon;   finishFunction = finishNeon;   break;
+#endif
+  default:     renderFunction = renderGeneric; finishFunction = finishGeneric; break;
+  }
+  selected = instructionSet;
+  return true;
+}
@@ -0,0 +1,90 @@
+#ifndef rosic_Open303Kernels_h
+#define rosic_Open303Kernels_h
+
+// rosic-indcludes:
+#include "GlobalDefinitions.h"
+
+namespace rosic
+{
+
+  class Open303;
+
+  /**
+
+  This holds the inner loops of Open303 - the oversampled loop with the oscillator, filter, 
+  drive and decimator (Open303::renderSample) and the filters behind the decimation 
+  (Open303::finishBlock) - compiled several times into the same binary, once for each 
+  instruction set in instructionSets. select() picks the variant that render() and finish() 
+  call, normally the best one the CPU supports (detectInstructionSet), so one build runs on any 
+  CPU of its architecture and still uses AVX2 or AVX-512 where they exist. Until select is 
+  called, the generic variant is used.
+
+  Each variant inlines the whole call tree of renderSample/finishBlock that is visible in the 
+  headers, so all of it is compiled for the variant's instruction set. Functions that are not 
+  inlined (in other translation units) stay generic.
+
+  */
+
+  class Open303Kernels
+  {
+
+  public:
+
+    /** The instruction sets with a variant of the kernels. */
+    enum instructionSets
+    {
+      GENERIC = 0,  // compiled with the flags of the build (SSE2 on x86, NEON on 64-bit ARM)
+      AVX2,         // x86 with AVX2 and FMA
+      AVX512,       // x86 with AVX-512 (F, VL, DQ and BW)
+      NEON,         // 32-bit ARM with NEON, when the build doesn't use it already
+
+      NUM_INSTRUCTION_SETS
+    };
+
+    /** Returns true if the kernels for the instruction set are compiled into this build. */
+    static bool isCompiled(int instructionSet);
+
+    /** Returns true if the kernels for the instruction set are compiled into this build and the 
+    CPU (and operating system) supports the instruction set. */
+    static bool isSupported(int instructionSet);
+
+    /** Returns the best instruction set that isSupported. */
+    static int detectInstructionSet();
+
+    /** Makes render and finish use the kernels for the instruction set. Returns false (and 
+    changes nothing) if it isn't supported. Not thread-safe - call it before rendering, for 
+    example when the plugin is loaded. */
+    static bool select(int instructionSet);
+
+    /** Returns the selected instruction set. */
+    static int getSelected() { return selected; }
+
+    /** Returns the name of an instruction set (for messages). */
+    static const char* getName(int instructionSet);
+
+    /** Calls o303.renderSamples(numSamples). */
+    static INLINE void render(Open303 &o303, int numSamples) 
+    { 
+      renderFunction(o303, numSamples); 
+    }
+
+    /** Calls o303.finishBlock(out). */
+    static INLINE void finish(Open303 &o303, float *out) 
+    { 
+      finishFunction(o303, out); 
+    }
+
+  protected:
+
+    typedef void (*RenderFunction)(Open303 &o303, int numSamples);
+    typedef void (*FinishFunction)(Open303 &o303, float *out);
+
+    static RenderFunction renderFunction;
+    static FinishFunction finishFunction;
+    static int            selected;
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_Open303Kernels_h
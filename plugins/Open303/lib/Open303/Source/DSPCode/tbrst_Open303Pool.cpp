@@ -0,0 +1,63 @@
+// rosic-includes:
+#include "tbrst_Open303Pool.h"
+
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+Open303Pool::Open303Pool()
+{
+  numFree  = 0;
+  numOwned = 0;
+}
+
+Open303Pool::~Open303Pool()
+{
+  for(int i=0; i<numFree; i++)
+    delete engines[i];
+  numFree  = 0;
+  numOwned = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+// engine management:
+
+int Open303Pool::add(Open303** newEngines, int numEngines)
+{
+  int numTaken = rmin(numEngines, maxNumEngines - numOwned.load());
+  int n        = numFree.load();
+  for(int i=0; i<numTaken; i++)
+    engines[n+i] = newEngines[i];
+  for(int i=numTaken; i<numEngines; i++)
+    newEngines[i-numTaken] = newEngines[i];
+  numOwned += numTaken;
+  numFree.store(n+numTaken);
+  return numEngines - numTaken;
+}
+
+Open303* Open303Pool::get()
+{
+  int n = numFree.load();
+  if( n == 0 )
+    return NULL;
+  numFree.store(n-1);
+  return engines[n-1];
+}
+
+void Open303Pool::put(Open303* engine)
+{
+  engine->reset();
+  int n = numFree.load();
+  engines[n] = engine;
+  numFree.store(n+1);
+}
+
+//-------------------------------------------------------------------------------------------------
+// inquiry:
+
+int Open303Pool::getNumMissing(int numWanted) const
+{
+  int numMissing = numWanted - numFree.load();
+  return rmax(0, rmin(numMissing, maxNumEngines - numOwned.load()));
+}
@@ -0,0 +1,90 @@
+#ifndef rosic_Open303Pool_h
+#define rosic_Open303Pool_h
+
+// standard-library includes:
+#include <atomic>
+
+// rosic-indcludes:
+#include "rosic_Open303.h"
+
+namespace rosic
+{
+
+  /**
+
+  A bounded pool of constructed Open303 engines, so that a voice can be started without
+  constructing an engine on the audio thread. The intended use is:
+
+  -construct engines with new on a non-realtime thread (e.g. stage 2 of an asynchronous command,
+   with the number to construct taken from getNumMissing()) and hand them over to the audio thread,
+   which add()s them to the pool
+  -get() an engine from the pool for every voice that starts, and put() it back when the voice
+   ends
+
+  Engines that don't fit into the pool anymore are handed back by add() and have to be deleted on
+  the non-realtime thread again. The pool owns the engines that were added to it, whether they
+  are currently handed out or not, and deletes them in its destructor. get(), put() and add() are
+  realtime safe and may only be called from one thread at a time (the audio thread).
+  getNumMissing() may be called from any thread.
+
+  */
+
+  class Open303Pool
+  {
+
+  public:
+
+    /** Maximum number of engines owned by the pool. Each one takes sizeof(Open303) bytes (at 
+    most 6 kB, see below), plus the tables of its built-in square wave if that was re-shaped, which
+    it renders itself. */
+    static const int maxNumEngines = 256;
+    static_assert(sizeof(Open303) <= 6*1024, "update the engine size given in the docs");
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    Open303Pool();
+
+    /** Destructor. Deletes all engines in the pool - none may be handed out anymore at this 
+    point. */
+    ~Open303Pool();
+
+    //---------------------------------------------------------------------------------------------
+    // engine management:
+
+    /** Takes over as many of the 'numEngines' engines in 'engines' as the pool has room for, and
+    moves the ones it didn't take to the front of the array. Returns the number of engines that
+    were not taken. */
+    int add(Open303** engines, int numEngines);
+
+    /** Returns an engine from the pool, or NULL if the pool is empty. The engine has been reset
+    (see Open303::reset) but keeps the parameters set by its previous user. */
+    Open303* get();
+
+    /** Puts an engine obtained from get() back into the pool and resets it. */
+    void put(Open303* engine);
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns the number of engines that would have to be added to have 'numWanted' of them
+    in the pool (limited by the room that is left). */
+    int getNumMissing(int numWanted) const;
+
+    /** Returns the number of engines in the pool which are not handed out. */
+    int getNumFree() const { return numFree.load(); }
+
+    //=============================================================================================
+
+  protected:
+
+    Open303*         engines[maxNumEngines]; // the free ones at the start, the others unused
+    std::atomic<int> numFree;                // number of engines in the pool
+    std::atomic<int> numOwned;               // number of engines in the pool and handed out
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_Open303Pool_h
@@ -0,0 +1,61 @@
+#ifndef rosic_PolyBlep_h
+#define rosic_PolyBlep_h
+
+// rosic-indcludes:
+#include "GlobalDefinitions.h"
+
+namespace rosic
+{
+
+  /**
+
+  Polynomial approximations of the band-limited step (BLEP) and ramp (BLAMP) residuals, i.e. the
+  difference between the band-limited and the naive version of a waveform around a discontinuity
+  in the value (BLEP) or in the slope (BLAMP). Both use 2 samples, one on each side of the
+  discontinuity. 't' is the distance from the discontinuity in cycles (0...1, the waveform is
+  periodic) and 'dt' the phase increment per sample in cycles (must be below 0.5).
+
+  To correct a naive waveform, add
+  0.5*h*polyBlep(t, dt) for a step of height h (value after minus value before) and
+  k*dt*polyBlamp(t, dt) for a change of the slope by k per cycle (slope after minus slope before),
+  where 't' is measured from the position of the step or slope change.
+
+  */
+
+  /** Residual of an upward step of height 2 (the usual rising sawtooth has a downward step of 
+  height 2, so it subtracts this). */
+  INLINE double polyBlep(double t, double dt)
+  {
+    if( t < dt )
+    {
+      double x = t/dt;           // 0...1 samples after the step
+      return x+x - x*x - 1.0;
+    }
+    else if( t > 1.0-dt )
+    {
+      double x = (t-1.0)/dt;     // -1...0 samples before the step
+      return x*x + x+x + 1.0;
+    }
+    return 0.0;
+  }
+
+  /** Residual of a kink where the slope increases by 1 per sample (the integral of 
+  0.5*polyBlep). */
+  INLINE double polyBlamp(double t, double dt)
+  {
+    if( t < dt )
+    {
+      double x = 1.0 - t/dt;
+      return (1.0/6.0) * x*x*x;
+    }
+    else if( t > 1.0-dt )
+    {
+      double x = (t-1.0)/dt + 1.0;
+      return (1.0/6.0) * x*x*x;
+    }
+    return 0.0;
+  }
+
+} // end namespace rosic
+
+#endif // rosic_PolyBlep_h
@@ -0,0 +1,93 @@
+// rosic-includes:
+#include "tbrst_PolyphaseUpsampler.h"
+
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// coefficients:
+
+// zeroth order modified Bessel function of the first kind (for the Kaiser window):
+static double besselI0(double x)
+{
+  double sum = 1.0, term = 1.0;
+  for(int k=1; k<50; k++)
+  {
+    term *= (0.5*x/k) * (0.5*x/k);
+    sum  += term;
+    if( term < 1.e-17*sum )
+      break;
+  }
+  return sum;
+}
+
+double PolyphaseUpsampler::coefficients[factor][tapsPerPhase];
+
+namespace rosic
+{
+
+struct PolyphaseUpsamplerCoefficients
+{
+  PolyphaseUpsamplerCoefficients()
+  {
+    double (&c)[PolyphaseUpsampler::factor][PolyphaseUpsampler::tapsPerPhase] = 
+      PolyphaseUpsampler::coefficients;
+
+    const int    factor = PolyphaseUpsampler::factor;
+    const int    taps   = PolyphaseUpsampler::tapsPerPhase;
+    const int    length = PolyphaseUpsampler::numTaps;
+    const double beta   = 8.0; // Kaiser window parameter, about 80dB sidelobe attenuation
+    const double center = 0.5*(length-1);
+
+    for(int n=0; n<length; n++)
+    {
+      // sinc with the cutoff at the Nyquist frequency of the input:
+      double t    = (n-center) / factor;
+      double sinc = (t == 0.0) ? 1.0 : sin(PI*t) / (PI*t);
+      double r    = (n-center) / center;
+      double w    = besselI0(beta*sqrt(1.0-r*r)) / besselI0(beta);
+
+      // tap n of the prototype belongs to phase n % factor and delay n / factor:
+      c[n % factor][n / factor] = sinc * w;
+    }
+
+    // unity gain at DC for each phase:
+    for(int p=0; p<factor; p++)
+    {
+      double sum = 0.0;
+      for(int k=0; k<taps; k++)
+        sum += c[p][k];
+      for(int k=0; k<taps; k++)
+        c[p][k] /= sum;
+    }
+  }
+};
+
+}
+
+// calculated when the library is loaded, so no PolyphaseUpsampler has to do it on the audio 
+// thread:
+static const PolyphaseUpsamplerCoefficients calculateCoefficients;
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+PolyphaseUpsampler::PolyphaseUpsampler()
+{
+  reset();
+}
+
+PolyphaseUpsampler::~PolyphaseUpsampler()
+{
+
+}
+
+//-------------------------------------------------------------------------------------------------
+// others:
+
+void PolyphaseUpsampler::reset(double value)
+{
+  for(int k=0; k<2*tapsPerPhase; k++)
+    history[k] = value;
+  writeIndex = 0;
+  numEqual   = tapsPerPhase;
+}
@@ -0,0 +1,112 @@
+#ifndef rosic_PolyphaseUpsampler_h
+#define rosic_PolyphaseUpsampler_h
+
+// standard-library includes:
+#include <math.h>
+
+// rosic-indcludes:
+#include "GlobalDefinitions.h"
+
+namespace rosic
+{
+
+  /**
+
+  This is a polyphase interpolator that raises the sample rate of a signal by 'factor' - one 
+  block of 'factor' samples per input sample - for signals that have to enter the oversampled 
+  loop of Open303 from outside (the external input). The prototype lowpass is a Kaiser-windowed 
+  sinc with its cutoff at the Nyquist frequency of the input, so the spectral images that a 
+  zero-order hold would leave in the oversampled signal are removed. Each phase is normalized to 
+  unity gain at DC, so a constant input comes out unchanged - once the history holds nothing else, 
+  the convolution is skipped and constant inputs cost next to nothing. The filter delays the 
+  signal by (numTaps-1)/2 samples of the oversampled rate.
+
+  */
+
+  class PolyphaseUpsampler
+  {
+
+  public:
+
+    /** Upsampling factor (the oversampling factor of Open303). */
+    static const int factor = 4;
+
+    /** Length of each polyphase branch in input samples. */
+    static const int tapsPerPhase = 12;
+
+    /** Length of the prototype lowpass. */
+    static const int numTaps = factor*tapsPerPhase;
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    PolyphaseUpsampler();
+
+    /** Destructor. */
+    ~PolyphaseUpsampler();
+
+    //---------------------------------------------------------------------------------------------
+    // audio processing:
+
+    /** Takes one input sample and writes the 'factor' interpolated samples to 'out'. */
+    INLINE void getSamples(double in, double *out);
+
+    //---------------------------------------------------------------------------------------------
+    // others:
+
+    /** Fills the history with 'value', as if the input had been constant at that value - for 
+    starting without a transient after the input was not fed for a while. */
+    void reset(double value = 0.0);
+
+  protected:
+
+    /** The polyphase branches of the prototype lowpass, one row per phase, taps for the newest 
+    input first - calculated when the library is loaded. */
+    static double coefficients[factor][tapsPerPhase];
+    friend struct PolyphaseUpsamplerCoefficients;
+
+    double history[2*tapsPerPhase]; // input history, stored twice so it can be read in one piece
+    int    writeIndex;              // position of the newest input in the first half of history
+    int    numEqual;                // number of inputs in a row that equal the newest one
+
+  };
+
+  //-----------------------------------------------------------------------------------------------
+  // inlined functions:
+
+  INLINE void PolyphaseUpsampler::getSamples(double in, double *out)
+  {
+    // a constant input that has filled the whole history comes out unchanged:
+    if( in == history[writeIndex] )
+    {
+      if( numEqual >= tapsPerPhase )
+      {
+        for(int p=0; p<factor; p++)
+          out[p] = in;
+        return;
+      }
+      numEqual++;
+    }
+    else
+      numEqual = 1;
+
+    writeIndex--;
+    if( writeIndex < 0 )
+      writeIndex += tapsPerPhase;
+    history[writeIndex]              = in;
+    history[writeIndex+tapsPerPhase] = in;
+
+    const double *x = &history[writeIndex];
+    for(int p=0; p<factor; p++)
+    {
+      double sum = 0.0;
+      for(int k=0; k<tapsPerPhase; k++)
+        sum += coefficients[p][k] * x[k];
+      out[p] = sum;
+    }
+  }
+
+}
+
+#endif
@@ -0,0 +1,53 @@
+// rosic-includes:
+#include "tbrst_PostFilterChain.h"
+
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+PostFilterChain::PostFilterChain()
+{
+  for(int k=0; k<numLanes; k++)
+  {
+    b0[k] = 1.0;
+    b1[k] = b2[k] = a1[k] = a2[k] = 0.0;
+  }
+  reset();
+}
+
+PostFilterChain::~PostFilterChain()
+{
+
+}
+
+//-------------------------------------------------------------------------------------------------
+// parameter settings:
+
+void PostFilterChain::setSection(int section, double newB0, double newB1, double newB2, 
+                                 double newA1, double newA2)
+{
+  if( section < 0 || section >= NUM_SECTIONS )
+    return;
+  b0[section] = newB0;
+  b1[section] = newB1;
+  b2[section] = newB2;
+  a1[section] = newA1;
+  a2[section] = newA2;
+}
+
+void PostFilterChain::setSection(int section, double b0A, double b1A, double a1A, double b0B, 
+                                 double b1B, double a1B)
+{
+  // multiply the numerators and the denominators (1 - a1*z^-1) of the two filters:
+  setSection(section, b0A*b0B, b0A*b1B + b1A*b0B, b1A*b1B, a1A + a1B, -a1A*a1B);
+}
+
+//-------------------------------------------------------------------------------------------------
+// others:
+
+void PostFilterChain::reset()
+{
+  for(int k=0; k<numLanes; k++)
+    s1[k] = s2[k] = 0.0;
+}
@@ -0,0 +1,140 @@
+#ifndef rosic_PostFilterChain_h
+#define rosic_PostFilterChain_h
+
+// rosic-indcludes:
+#include "GlobalDefinitions.h"
+#include "tbrst_DenormalGuard.h" // for ANTI_DENORMAL
+
+namespace rosic
+{
+
+  /**
+
+  This runs the fixed filters behind the decimation in Open303 - the allpass and the highpass 
+  (combined into one second order section), the notch and the declicker of the amp envelope - 
+  as second order sections in transposed direct form II, over a block of samples. Each section 
+  is a lane of a small vector: the notch processes the output of the allpass/highpass section of
+  the previous sample, so all lanes are independent in each step and the compiler can turn the 
+  inner loop of processBlock() into SIMD code.
+
+  Coefficients use the sign convention of BiquadFilter: 
+  y[n] = b0*x[n] + b1*x[n-1] + b2*x[n-2] + a1*y[n-1] + a2*y[n-2].
+
+  */
+
+  class PostFilterChain
+  {
+
+  public:
+
+    /** The sections. */
+    enum sections
+    {
+      ALLPASS_HIGHPASS = 0,  // on the signal
+      NOTCH,                 // on the output of ALLPASS_HIGHPASS
+      DECLICKER,             // on the amplitude
+
+      NUM_SECTIONS
+    };
+
+    /** Number of lanes (sections, padded to a SIMD-friendly size). */
+    static const int numLanes = 4;
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. All sections pass their input unchanged. */
+    PostFilterChain();
+
+    /** Destructor. */
+    ~PostFilterChain();
+
+    //---------------------------------------------------------------------------------------------
+    // parameter settings:
+
+    /** Sets the coefficients of one of the sections (@see sections). */
+    void setSection(int section, double b0, double b1, double b2, double a1, double a2);
+
+    /** Sets the coefficients of one of the sections to the product of two first order filters
+    (with y[n] = b0*x[n] + b1*x[n-1] + a1*y[n-1]). */
+    void setSection(int section, double b0A, double b1A, double a1A, double b0B, double b1B, 
+                    double a1B);
+
+    //---------------------------------------------------------------------------------------------
+    // audio processing:
+
+    /** Filters a block of 'length' samples (at least 1) in place: 'signal' through the 
+    ALLPASS_HIGHPASS and NOTCH sections, 'amplitude' through the DECLICKER section. */
+    INLINE void processBlock(double *signal, double *amplitude, int length);
+
+    //---------------------------------------------------------------------------------------------
+    // others:
+
+    /** Resets the states of all sections to zero. */
+    void reset();
+
+  protected:
+
+    /** Processes one sample in one lane only. */
+    INLINE double tickLane(int k, double in);
+
+    // coefficients and states, one lane per section:
+    double b0[numLanes], b1[numLanes], b2[numLanes], a1[numLanes], a2[numLanes];
+    double s1[numLanes], s2[numLanes];
+
+  };
+
+  //-----------------------------------------------------------------------------------------------
+  // inlined functions:
+
+  INLINE double PostFilterChain::tickLane(int k, double in)
+  {
+    double y = ANTI_DENORMAL(b0[k]*in + s1[k]);
+    s1[k]    = b1[k]*in + a1[k]*y + s2[k];
+    s2[k]    = b2[k]*in + a2[k]*y;
+    return y;
+  }
+
+  INLINE void PostFilterChain::processBlock(double *signal, double *amplitude, int length)
+  {
+    // the notch runs one sample behind, so the first sample only enters the other sections:
+    double delayed  = tickLane(ALLPASS_HIGHPASS, signal[0]);
+    amplitude[0]    = tickLane(DECLICKER, amplitude[0]);
+
+    // work on local copies of the states, so the compiler knows they don't alias the buffers:
+    double t1[numLanes], t2[numLanes];
+    for(int k=0; k<numLanes; k++)
+    {
+      t1[k] = s1[k];
+      t2[k] = s2[k];
+    }
+
+    for(int n=1; n<length; n++)
+    {
+      double in[numLanes] = { signal[n], delayed, amplitude[n], 0.0 };
+      double out[numLanes];
+      for(int k=0; k<numLanes; k++) // independent lanes - vectorizes
+      {
+        double y = ANTI_DENORMAL(b0[k]*in[k] + t1[k]);
+        t1[k]    = b1[k]*in[k] + a1[k]*y + t2[k];
+        t2[k]    = b2[k]*in[k] + a2[k]*y;
+        out[k]   = y;
+      }
+      delayed        = out[ALLPASS_HIGHPASS];
+      signal[n-1]    = out[NOTCH];
+      amplitude[n]   = out[DECLICKER];
+    }
+
+    for(int k=0; k<numLanes; k++)
+    {
+      s1[k] = t1[k];
+      s2[k] = t2[k];
+    }
+
+    // ...and the last sample only through the notch:
+    signal[length-1] = tickLane(NOTCH, delayed);
+  }
+
+}
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef rosic_PrecomputedWaveTables_h
+#define rosic_PrecomputedWaveTables_h
+
+// rosic-indcludes:
+#include "rosic_MipMappedWaveTable.h"
+
+namespace rosic
+{
+
+  /**
+
+  Mip-maps of the SAW303 and SQUARE303 waveforms (the latter with the default tanh-shaper settings)
+  rendered at build time by the Open303TableGen tool and linked into the binary as read-only data.
+  MipMappedWaveTable points to these instead of rendering when it is compiled with 
+  OPEN303_PRECOMPUTED_TABLES, which keeps FFTs off the audio thread when a synth is created.
+
+  */
+
+  extern const double precomputedSaw303Tables
+    [MipMappedWaveTable::numTables][MipMappedWaveTable::tableLength+4];
+
+  extern const double precomputedSquare303Tables
+    [MipMappedWaveTable::numTables][MipMappedWaveTable::tableLength+4];
+
+#ifdef OPEN303_FLOAT_WAVETABLES
+  // both tables in single precision and interleaved (see MipMappedWaveTable::InterleavedLevel):
+  extern const MipMappedWaveTable::InterleavedLevel precomputedSaw303Square303Levels
+    [MipMappedWaveTable::numTables];
+#endif
+
+} // end namespace rosic
+
+#endif // rosic_PrecomputedWaveTables_h
@@ -10,8 +10,10 @@ using namespace rosic;
 TeeBeeFilterMorph::TeeBeeFilterMorph()
 {
   morphPosition = 0.0;
+  ladder        = STANDARD_LADDER;
+  lowpassMode   = TeeBeeFilter::TB_303;
   filter0.setMode(15);  // TB_303 mode initially
-  filter1.setMode(9);   // BP_12_12 bandpass mode (remains in this mode)
+  filter1.setMode(9);   // BP_12_12 bandpass mode (remains in this mode, getSample relies on it)
 }
 
 TeeBeeFilterMorph::~TeeBeeFilterMorph()
@@ -40,12 +42,27 @@ void TeeBeeFilterMorph::setFilterMorph(double newMorphPosition)
   // Change filter0 filter mode
   // filter1 stays in band-pass mode. This way, filter 1 only switches mode when it's silent (avoiding clicks).
   if(morphPosition <= 0.5) {
-    filter0.setMode(15);  // TB_303 mode
+    filter0.setMode(lowpassMode);  // TB_303, TB_303_ZDF or TB_303_NONLINEAR mode
   } else {
     filter0.setMode(8);   // HP_24 high-pass mode
   }
 }
 
+void TeeBeeFilterMorph::setLadder(int newLadder)
+{
+  if(newLadder < 0 || newLadder >= NUM_LADDERS)
+    return;
+  ladder = newLadder;
+  switch(ladder)
+  {
+    case ZDF_LADDER:       lowpassMode = TeeBeeFilter::TB_303_ZDF;       break;
+    case NONLINEAR_LADDER: lowpassMode = TeeBeeFilter::TB_303_NONLINEAR; break;
+    default:               lowpassMode = TeeBeeFilter::TB_303;           break;
+  }
+  if(morphPosition <= 0.5)
+    filter0.setMode(lowpassMode);
+}
+
 //-------------------------------------------------------------------------------------------------
 // others:
 
@@ -41,9 +41,20 @@ namespace rosic
       BP_6_12   = 12,
       BP_12_6   = 13,
       BP_6_6    = 14,
-      TB_303    = 15
+      TB_303    = 15,
+      TB_303_ZDF = 16,
+      TB_303_NONLINEAR = 17
     */
 
+    /** Solutions of the 303 ladder for the low-pass end of the morph. */
+    enum ladders
+    {
+      STANDARD_LADDER = 0,  // TB_303
+      ZDF_LADDER,           // TB_303_ZDF
+      NONLINEAR_LADDER,     // TB_303_NONLINEAR
+      NUM_LADDERS
+    };
+
     //---------------------------------------------------------------------------------------------
     // construction/destruction:
 
@@ -64,6 +75,49 @@ namespace rosic
     manually later by calling calculateCoefficients. */
     INLINE void setCutoff(double newCutoff, bool updateCoefficients = true);
 
+    /** Ramps the cutoff frequency of both filters, @see TeeBeeFilter::setCutoffRamp. */
+    INLINE void setCutoffRamp(double newCutoff, int numSamples)
+    {
+      filter0.setCutoffRamp(newCutoff, numSamples);
+      filter1.setCutoffRamp(newCutoff, numSamples);
+    }
+
+    /** Moves the coefficients of both filters one step along their ramps. */
+    INLINE void advanceCoefficients()
+    {
+      filter0.advanceCoefficients();
+      filter1.advanceCoefficients();
+    }
+
+    /** Sets the depth of the cutoff modulation of both filters, @see 
+    TeeBeeFilter::setCutoffFmDepth. */
+    void setCutoffFmDepth(double newDepth)
+    {
+      filter0.setCutoffFmDepth(newDepth);
+      filter1.setCutoffFmDepth(newDepth);
+    }
+
+    /** @see TeeBeeFilter::beginCutoffFm. */
+    INLINE void beginCutoffFm()
+    {
+      filter0.beginCutoffFm();
+      filter1.beginCutoffFm();
+    }
+
+    /** Modulates the cutoff of both filters, @see TeeBeeFilter::applyCutoffFm. */
+    INLINE void applyCutoffFm(double factor)
+    {
+      filter0.applyCutoffFm(factor);
+      filter1.applyCutoffFm(factor);
+    }
+
+    /** @see TeeBeeFilter::endCutoffFm. */
+    INLINE void endCutoffFm()
+    {
+      filter0.endCutoffFm();
+      filter1.endCutoffFm();
+    }
+
     /** Sets the resonance in percent where 100% is self oscillation. */
     INLINE void setResonance(double newResonance, bool updateCoefficients = true);
 
@@ -80,6 +134,9 @@ namespace rosic
     /** Set filter morph. */
     void setFilterMorph(double newMorphPosition);
 
+    /** Selects the solution of the 303 ladder for the low-pass end of the morph, @see ladders. */
+    void setLadder(int newLadder);
+
     /** Resets the internal state variables. */
     void reset();
 
@@ -94,10 +151,17 @@ namespace rosic
 
     /** Returns filter morph-position */
     double getFilterMorph() { return morphPosition; };
+
+    /** Returns the solution of the 303 ladder, @see ladders. */
+    int getLadder() const { return ladder; }
     
     /** Returns the drive parameter in decibels. */
     double getDrive() const { return filter0.getDrive(); }
 
+    /** Returns the mode of filter0 - TB_303, TB_303_ZDF or TB_303_NONLINEAR (the ladder) in the 
+    low-pass half of the morph, HP_24 in the high-pass half. */
+    int getFilter0Mode() const { return filter0.getMode(); }
+
     /** Returns the cutoff frequency for the highpass filter in the feedback path. */
     double getFeedbackHighpassCutoff() const { return filter0.getFeedbackHighpassCutoff(); }
 
@@ -110,6 +174,12 @@ namespace rosic
     /** Calculates one output sample at a time. */
     INLINE double getSample(double in);
 
+    /** Calculates one output sample with filter0 running the kernel for mode M, which must be its
+    current mode (@see getFilter0Mode). For callers that pick the mode once per block, so the 
+    kernels of both filters are inlined. */
+    template<int M>
+    INLINE double getSampleForMode(double in);
+
     //-----------------------------------------------------------------------------------------------
     // embedded objects: 
 
@@ -118,6 +188,8 @@ namespace rosic
   protected:
 
     double morphPosition;       // morph position
+    int    ladder;              // solution of the 303 ladder
+    int    lowpassMode;         // mode of filter0 for the low-pass half of the morph
 
   };
 
@@ -137,14 +209,27 @@ namespace rosic
   }
 
   INLINE double TeeBeeFilterMorph::getSample(double in)
+  {
+    switch( filter0.getMode() )
+    {
+    case TeeBeeFilter::TB_303:           return getSampleForMode<TeeBeeFilter::TB_303>(in);
+    case TeeBeeFilter::TB_303_ZDF:       return getSampleForMode<TeeBeeFilter::TB_303_ZDF>(in);
+    case TeeBeeFilter::TB_303_NONLINEAR: return getSampleForMode<TeeBeeFilter::TB_303_NONLINEAR>(in);
+    default:                             return getSampleForMode<TeeBeeFilter::HP_24>(in);
+    }
+  }
+
+  template<int M>
+  INLINE double TeeBeeFilterMorph::getSampleForMode(double in)
   {
     double fracPos, intPos, f0, f1, out;
 
     fracPos = morphPosition * 2.0;    // multiply position by 2 to get repeating 0-1 ramp between pos 0>0.5 and 0.5>1.0
     fracPos = modf(fracPos, &intPos); // (integer part not used)
 
-    f0 = filter0.getSample(in);
-    f1 = filter1.getSample(in);
+    // filter1 never leaves the BP_12_12 mode:
+    f0 = filter0.getSampleForMode<M>(in);
+    f1 = filter1.getSampleForMode<TeeBeeFilter::BP_12_12>(in);
     
     // Set blend mode
     if(morphPosition <= 0.5) {
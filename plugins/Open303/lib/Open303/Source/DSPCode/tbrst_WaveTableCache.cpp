@@ -0,0 +1,127 @@
+// rosic-includes:
+#include "tbrst_WaveTableCache.h"
+
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+WaveTableCache::WaveTableCache()
+{
+  useClock = 0;
+#ifdef OPEN303_FLOAT_WAVETABLES
+  sawTable.setWaveform(MipMappedWaveTable::SAW303);
+#endif
+}
+
+WaveTableCache::~WaveTableCache()
+{
+  for(int i=0; i<maxNumEntries; i++)
+  {
+    delete entries[i].table.load();
+    entries[i].table.store(NULL);
+  }
+}
+
+//-------------------------------------------------------------------------------------------------
+// table management:
+
+MipMappedWaveTable* WaveTableCache::acquire(const WaveTableKey& key)
+{
+  useClock++;
+
+  // cache hit:
+  int i;
+  for(i=0; i<maxNumEntries; i++)
+  {
+    if( entries[i].table != NULL && entries[i].key == key )
+    {
+      entries[i].lastUsed = useClock;
+      entries[i].useCount++;
+      return entries[i].table;
+    }
+  }
+
+  // cache miss - take an empty slot if there is one, otherwise evict the least recently used
+  // table that is not in use anymore:
+  int slot = -1;
+  for(i=0; i<maxNumEntries; i++)
+  {
+    if( entries[i].table == NULL )
+    {
+      slot = i;
+      break;
+    }
+  }
+  if( slot < 0 )
+  {
+    for(i=0; i<maxNumEntries; i++)
+    {
+      if( entries[i].useCount.load() == 0
+        && (slot < 0 || entries[i].lastUsed < entries[slot].lastUsed) )
+        slot = i;
+    }
+  }
+  if( slot < 0 )
+    return NULL; // all tables are in use
+
+  Entry& entry = entries[slot];
+  MipMappedWaveTable* table = entry.table.load();
+  if( table == NULL )
+  {
+    table = new MipMappedWaveTable;
+#ifdef OPEN303_FLOAT_WAVETABLES
+    table->setInterleavePartner(&sawTable);
+#endif
+  }
+  table->setWaveformParameters(key.waveform, key.symmetry, key.tanhShaperDrive,
+    key.tanhShaperOffset, key.squarePhaseShift, &scratch);
+  entry.key      = key;
+  entry.lastUsed = useClock;
+  entry.useCount.store(1);
+  entry.table.store(table);
+  return table;
+}
+
+void WaveTableCache::retain(MipMappedWaveTable* table)
+{
+  int slot = findSlot(table);
+  if( slot >= 0 )
+    entries[slot].useCount++;
+}
+
+void WaveTableCache::release(MipMappedWaveTable* table)
+{
+  int slot = findSlot(table);
+  if( slot >= 0 )
+    entries[slot].useCount--;
+}
+
+//-------------------------------------------------------------------------------------------------
+// inquiry:
+
+int WaveTableCache::getNumEntries() const
+{
+  int n = 0;
+  for(int i=0; i<maxNumEntries; i++)
+  {
+    if( entries[i].table != NULL )
+      n++;
+  }
+  return n;
+}
+
+//-------------------------------------------------------------------------------------------------
+// internal functions:
+
+int WaveTableCache::findSlot(const MipMappedWaveTable* table) const
+{
+  if( table == NULL )
+    return -1;
+  for(int i=0; i<maxNumEntries; i++)
+  {
+    if( entries[i].table == table )
+      return i;
+  }
+  return -1;
+}
@@ -0,0 +1,124 @@
+#ifndef rosic_WaveTableCache_h
+#define rosic_WaveTableCache_h
+
+// standard-library includes:
+#include <atomic>
+
+// rosic-indcludes:
+#include "rosic_MipMappedWaveTable.h"
+
+namespace rosic
+{
+
+  /**
+
+  Set of parameters that fully determines the content of a rendered MipMappedWaveTable. Used as
+  lookup key in the WaveTableCache.
+
+  */
+
+  struct WaveTableKey
+  {
+    int    waveform;          // one of MipMappedWaveTable::waveforms
+    double symmetry;          // 0...1
+    double tanhShaperDrive;   // in dB
+    double tanhShaperOffset;  // raw value
+    double squarePhaseShift;  // in degrees
+
+    bool operator==(const WaveTableKey& other) const
+    {
+      return waveform         == other.waveform
+          && symmetry         == other.symmetry
+          && tanhShaperDrive  == other.tanhShaperDrive
+          && tanhShaperOffset == other.tanhShaperOffset
+          && squarePhaseShift == other.squarePhaseShift;
+    }
+  };
+
+  /**
+
+  A bounded, least-recently-used cache of rendered mip-mapped wavetables, keyed by the waveform
+  and shaper parameters. Rendering a table costs one FFT and 11 inverse FFTs of 2048 points, which
+  is far too expensive for the audio thread. The intended use is:
+
+  -acquire() the table for a key from a non-realtime thread (e.g. stage 2 of an asynchronous
+   command), which renders it if it isn't cached yet
+  -hand the returned pointer over to the audio thread, which may retain() it for every oscillator
+   that switches to it and release() it when the oscillator switches away
+  -release() the reference obtained from acquire() when it is not needed anymore
+
+  Tables whose use count has dropped to zero stay cached until their slot is needed for another
+  key. The memory used is bounded by maxNumEntries tables. retain() and release() are realtime
+  safe, acquire() is not. With OPEN303_FLOAT_WAVETABLES, the tables also keep their levels 
+  interleaved with a SAW303 table (the 1st waveform of Open303's oscillator).
+
+  */
+
+  class WaveTableCache
+  {
+
+  public:
+
+    /** Maximum number of tables held by the cache (each one takes roughly 200 kB, plus another 
+    200 kB for the interleaved levels with OPEN303_FLOAT_WAVETABLES). */
+    static const int maxNumEntries = 8;
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    WaveTableCache();
+
+    /** Destructor. Frees all tables - none of them may be in use anymore at this point. */
+    ~WaveTableCache();
+
+    //---------------------------------------------------------------------------------------------
+    // table management:
+
+    /** Returns the table for the given key with its use count incremented, rendering it into the
+    least recently used free slot if it is not cached yet. Returns NULL if all slots are in use.
+    Not realtime safe - call this only from a non-realtime thread (and only from one thread at a
+    time). */
+    MipMappedWaveTable* acquire(const WaveTableKey& key);
+
+    /** Increments the use count of a table obtained from acquire(). NULL is ignored. */
+    void retain(MipMappedWaveTable* table);
+
+    /** Decrements the use count of a table obtained from acquire(). NULL is ignored. */
+    void release(MipMappedWaveTable* table);
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns the number of tables which are currently rendered and held by the cache. */
+    int getNumEntries() const;
+
+    //=============================================================================================
+
+  protected:
+
+    /** Returns the slot index of the table or -1 if it doesn't belong to this cache. */
+    int findSlot(const MipMappedWaveTable* table) const;
+
+    struct Entry
+    {
+      WaveTableKey                     key;
+      std::atomic<MipMappedWaveTable*> table{NULL};  // allocated when the slot is first used
+      std::atomic<int>                 useCount{0};
+      unsigned long                    lastUsed{0};  // value of useClock at the last acquire()
+    };
+
+    Entry         entries[maxNumEntries];
+    unsigned long useClock;              // incremented on each acquire() for the LRU ordering
+
+    MipMappedWaveTable::RenderScratch scratch;  // shared by all renders done in acquire()
+
+#ifdef OPEN303_FLOAT_WAVETABLES
+    MipMappedWaveTable sawTable;  // the 1st table of the interleaved levels of all our tables
+#endif
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_WaveTableCache_h
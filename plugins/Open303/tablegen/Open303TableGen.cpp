@@ -0,0 +1,75 @@
+// Open303TableGen.cpp
+// toneburst (the_voder@yahoo.co.uk)
+/*
+  Build-time tool: renders the default SAW303 and SQUARE303 mip-maps and writes them out as a C++
+  source file defining the tables declared in tbrst_PrecomputedWaveTables.h. The interleaved single
+  precision copy is written too, inside #ifdef OPEN303_FLOAT_WAVETABLES like its declaration.
+
+  Usage: Open303TableGen <output.cpp> <path to tbrst_PrecomputedWaveTables.h>
+*/
+
+#include <cstdio>
+
+// Must be built without OPEN303_PRECOMPUTED_TABLES, so the tables actually get rendered
+#include "../lib/Open303/Source/DSPCode/rosic_MipMappedWaveTable.h"
+
+using rosic::MipMappedWaveTable;
+
+static void writeTableSet(FILE* file, const char* name, const MipMappedWaveTable& waveTable) {
+    fprintf(file, "const double %s[%d][%d] = {\n", name,
+        MipMappedWaveTable::numTables, MipMappedWaveTable::tableLength+4);
+    for(int t = 0; t < MipMappedWaveTable::numTables; ++t) {
+        const double* table = waveTable.getTable(t);
+        fprintf(file, "  {\n");
+        for(int i = 0; i < MipMappedWaveTable::tableLength+4; ++i)
+            fprintf(file, "%s%.17g,%s", (i % 4 == 0) ? "    " : " ", table[i], (i % 4 == 3) ? "\n" : "");
+        fprintf(file, "\n  },\n");
+    }
+    fprintf(file, "};\n\n");
+}
+
+static void writeInterleavedLevels(FILE* file, const char* name, const MipMappedWaveTable& first,
+    const MipMappedWaveTable& second) {
+    // an array of MipMappedWaveTable::InterleavedLevel, which takes care of the alignment
+    fprintf(file, "const MipMappedWaveTable::InterleavedLevel %s[%d] = {\n", name,
+        MipMappedWaveTable::numTables);
+    for(int t = 0; t < MipMappedWaveTable::numTables; ++t) {
+        const double* tables[2] = { first.getTable(t), second.getTable(t) };
+        fprintf(file, "  {{\n");
+        // 9 significant digits round-trip a float exactly
+        for(int i = 0; i < 2*(MipMappedWaveTable::tableLength+4); ++i)
+            fprintf(file, "%s%.8ef,%s", (i % 4 == 0) ? "    " : " ", (double) (float) tables[i % 2][i / 2],
+                (i % 4 == 3) ? "\n" : "");
+        fprintf(file, "\n  }},\n");
+    }
+    fprintf(file, "};\n\n");
+}
+
+int main(int argc, char** argv) {
+    if(argc < 3) {
+        fprintf(stderr, "Usage: %s <output.cpp> <path to tbrst_PrecomputedWaveTables.h>\n", argv[0]);
+        return 1;
+    }
+
+    // Same setup as the rosic::Open303 constructor
+    MipMappedWaveTable saw303, square303;
+    saw303.setWaveform(MipMappedWaveTable::SAW303);
+    square303.setWaveform(MipMappedWaveTable::SQUARE303);
+
+    FILE* file = fopen(argv[1], "w");
+    if(file == NULL) {
+        fprintf(stderr, "Open303TableGen: could not open %s for writing\n", argv[1]);
+        return 1;
+    }
+    fprintf(file, "// Generated by Open303TableGen - do not edit.\n\n");
+    fprintf(file, "#include \"%s\"\n\n", argv[2]);
+    fprintf(file, "namespace rosic {\n\n");
+    writeTableSet(file, "precomputedSaw303Tables",    saw303);
+    writeTableSet(file, "precomputedSquare303Tables", square303);
+    fprintf(file, "#ifdef OPEN303_FLOAT_WAVETABLES\n\n");
+    writeInterleavedLevels(file, "precomputedSaw303Square303Levels", saw303, square303);
+    fprintf(file, "#endif\n\n");
+    fprintf(file, "} // end namespace rosic\n");
+
+    return fclose(file) == 0 ? 0 : 1;
+}
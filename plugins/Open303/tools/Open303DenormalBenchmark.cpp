@@ -0,0 +1,111 @@
+// Open303DenormalBenchmark.cpp
+// toneburst (the_voder@yahoo.co.uk)
+/*
+  Benchmark tool: plays an accented note through Open303, releases it and renders the release
+  tail, with and without a DenormalGuard around the rendering. The engine is built without the
+  TINY offsets in the filters (OPEN303_FLUSH_DENORMALS, as in the plugin), so without the guard the
+  decaying envelopes run into denormals (about half a minute into the tail with these settings).
+  For the held note (the first second) and for each 5 seconds of the tail it prints the CPU time
+  per output sample without and with the guard, as the fastest and the slowest of numRuns runs.
+  The runs take turns, so they see the same load on the machine. The engine is set up completely
+  (including the waveform), so no state is left over from the stack.
+
+  Usage: Open303DenormalBenchmark
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "../lib/Open303/Source/DSPCode/rosic_Open303.h"
+#include "../lib/Open303/Source/DSPCode/tbrst_DenormalGuard.h"
+#include "../lib/Open303/Source/DSPCode/tbrst_Open303Kernels.h"
+
+using rosic::Open303;
+using rosic::Open303Kernels;
+using rosic::DenormalGuard;
+
+static const double sampleRate  = 48000.0;
+static const int    blockSize   = 64;
+static const int    second      = 750*blockSize; // blocks of 64 samples per second at 48kHz
+static const int    tailSeconds = 60;
+static const int    segment     = 5;              // seconds of the tail per printed row
+static const int    numRuns     = 5;
+
+typedef std::chrono::steady_clock Clock;
+
+// Renders one second in blocks, each under a DenormalGuard if 'guard' is set (like the UGen's calc
+// function), and returns the time per sample in ns
+static double renderSecond(Open303& o303, bool guard, float* out) {
+    Clock::time_point start = Clock::now();
+    for(int n = 0; n < second; n += blockSize) {
+        if(guard) {
+            DenormalGuard denormalGuard;
+            Open303Kernels::render(o303, blockSize);
+            Open303Kernels::finish(o303, out + n);
+        }
+        else {
+            Open303Kernels::render(o303, blockSize);
+            Open303Kernels::finish(o303, out + n);
+        }
+    }
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / second;
+}
+
+// Times the held note (ns[0]) and each segment of the tail (ns[1...])
+static void render(bool guard, std::vector<double>& ns, std::vector<float>& out) {
+    Open303 o303;
+    o303.setSampleRate(sampleRate);
+    o303.setWaveform(0.0);
+    o303.setCutoff(500.0);
+    o303.setResonance(80.0);
+    o303.setEnvMod(80.0);
+    o303.setDecay(400.0);
+    o303.setAccent(100.0);
+
+    o303.triggerNote(36, true);
+    ns[0] = renderSecond(o303, guard, &out[0]);
+    o303.allNotesOff();
+    for(int s = 0; s < tailSeconds; ++s)
+        ns[1 + s/segment] += renderSecond(o303, guard, &out[0]) / segment;
+}
+
+// Prints the fastest and the slowest time of the runs for row i
+static void printRow(const char* label, const std::vector<std::vector<double>>& plain,
+    const std::vector<std::vector<double>>& guarded, int i) {
+    double plainMin = 1e9, plainMax = 0.0, guardedMin = 1e9, guardedMax = 0.0;
+    for(int run = 0; run < numRuns; ++run) {
+        plainMin   = std::min(plainMin,   plain[run][i]);
+        plainMax   = std::max(plainMax,   plain[run][i]);
+        guardedMin = std::min(guardedMin, guarded[run][i]);
+        guardedMax = std::max(guardedMax, guarded[run][i]);
+    }
+    printf("%-12s %9.1f %9.1f   %9.1f %9.1f %9.2fx\n", label, plainMin, plainMax, guardedMin,
+        guardedMax, plainMin / guardedMin);
+}
+
+int main() {
+    Open303Kernels::select(Open303Kernels::detectInstructionSet());
+
+    const int numRows = 1 + tailSeconds/segment;
+    std::vector<std::vector<double>> nsPlain(numRuns, std::vector<double>(numRows, 0.0));
+    std::vector<std::vector<double>> nsGuarded(numRuns, std::vector<double>(numRows, 0.0));
+    std::vector<float> out(second);
+    for(int run = 0; run < numRuns; ++run) {
+        render(false, nsPlain[run],   out);
+        render(true,  nsGuarded[run], out);
+    }
+
+    printf("denormal guard %s on this platform, %d runs\n",
+        DenormalGuard::isSupported ? "supported" : "NOT supported", numRuns);
+    printf("%-12s %-19s   %-19s\n", "", "no guard", "guard");
+    printf("%-12s %9s %9s   %9s %9s %10s\n", "ns/sample", "min", "max", "min", "max", "ratio");
+    printRow("held note", nsPlain, nsGuarded, 0);
+    for(int row = 1; row < numRows; ++row) {
+        char label[32];
+        snprintf(label, sizeof(label), "tail %2d-%2ds", (row-1)*segment, row*segment);
+        printRow(label, nsPlain, nsGuarded, row);
+    }
+    return 0;
+}
@@ -0,0 +1,154 @@
+// Open303DriveBenchmark.cpp
+// toneburst (the_voder@yahoo.co.uk)
+/*
+  Benchmark tool: compares the ways of running the DriveStage of Open303 - inside the 4x
+  oversampled loop (followed by the elliptic decimation filter, as in Open303::getSample) and at
+  the base rate, naively or with 1st/2nd order antiderivative anti-aliasing (ADAA). For each
+  shaper it prints the CPU time per output sample and the level of the aliased (inharmonic)
+  components relative to the harmonics, for a sine at a few frequencies driven by +12dB.
+
+  Usage: Open303DriveBenchmark
+*/
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "../lib/Open303/Source/DSPCode/tbrst_DriveStage.h"
+#include "../lib/Open303/Source/DSPCode/rosic_EllipticQuarterBandFilter.h"
+#include "../lib/Open303/Source/DSPCode/rosic_FourierTransformerRadix2.h"
+
+using rosic::DriveStage;
+using rosic::EllipticQuarterBandFilter;
+using rosic::FourierTransformerRadix2;
+
+static const int    oversampling = 4;
+static const double baseRate     = 44100.0;
+static const int    fftSize      = 16384;
+static const int    settle       = 4096;    // samples discarded before the analysis
+static const int    numTimed     = 2000000; // output samples per timing run
+static const double drive        = 12.0;
+
+typedef std::chrono::steady_clock Clock;
+
+enum methods { OVERSAMPLED = 0, BASE_RATE, BASE_RATE_ADAA1, BASE_RATE_ADAA2, NUM_METHODS };
+
+// One period of fftSize output samples of a sine at frequency 'bin' * baseRate / fftSize,
+// sampled at 'os' times the base rate
+static std::vector<double> tabulateSine(int bin, int os) {
+    std::vector<double> sine(fftSize*os);
+    for(int n = 0; n < fftSize*os; ++n)
+        sine[n] = sin(2.0*PI*bin*n/(fftSize*os));
+    return sine;
+}
+
+// Renders numSamples output samples of the tabulated sine (repeated) through the drive stage with
+// the given method, so the timing covers only the drive stage and the decimation filter
+static void render(int shaper, int method, const std::vector<double>& sine, int numSamples, double* out) {
+    DriveStage stage;
+    stage.setMode(shaper);
+    stage.setDrive(drive);
+    stage.setTone(20000.0);
+    EllipticQuarterBandFilter decimator;
+
+    if(method == OVERSAMPLED) {
+        stage.setSampleRate(oversampling*baseRate);
+        for(int n = 0; n < numSamples; ++n) {
+            const double* in = &sine[(n % fftSize)*oversampling];
+            double y = 0.0;
+            for(int i = 0; i < oversampling; ++i)
+                y = decimator.getSample(stage.getSample(in[i]));
+            out[n] = y;
+        }
+    }
+    else {
+        stage.setSampleRate(baseRate);
+        stage.setAntiAliasing(method - BASE_RATE);
+        for(int n = 0; n < numSamples; ++n)
+            out[n] = stage.getSample(sine[n % fftSize]);
+    }
+}
+
+// Ratio (in dB) of the power in the inharmonic bins to the power in the harmonics, from a
+// Blackman-Harris windowed spectrum. The sine sits exactly on 'bin', so all harmonics and all
+// aliases fall on bins, too.
+static double aliasLevel(const double* signal, int bin, FourierTransformerRadix2& fft) {
+    std::vector<double> windowed(fftSize), magnitudes(fftSize/2);
+    for(int n = 0; n < fftSize; ++n) {
+        double p = 2.0*PI*n/fftSize;
+        double w = 0.35875 - 0.48829*cos(p) + 0.14128*cos(2*p) - 0.01168*cos(3*p);
+        windowed[n] = w*signal[n];
+    }
+    fft.getRealSignalMagnitudes(&windowed[0], &magnitudes[0]);
+
+    const int mainLobe = 4; // half-width of the window's main lobe in bins
+    const int maxBin   = (int) (20000.0/baseRate*fftSize);
+    std::vector<bool> harmonic(fftSize/2, false);
+    for(int h = bin; h < fftSize/2; h += bin)
+        for(int k = h-mainLobe; k <= h+mainLobe; ++k)
+            if(k >= 0 && k < fftSize/2)
+                harmonic[k] = true;
+
+    double harmonicPower = 0.0, aliasPower = 0.0;
+    for(int k = 1+mainLobe; k < maxBin; ++k) { // skip DC
+        double p = magnitudes[k]*magnitudes[k];
+        if(harmonic[k])
+            harmonicPower += p;
+        else
+            aliasPower += p;
+    }
+    return 10.0*log10(aliasPower/harmonicPower);
+}
+
+int main() {
+    const int   shapers[]     = { DriveStage::SOFT, DriveStage::HARD, DriveStage::ASYMMETRIC, DriveStage::TANH };
+    const char* shaperNames[] = { "soft", "hard", "asymmetric", "tanh" };
+    const char* methodNames[] = { "4x oversampled", "base rate", "base rate adaa1", "base rate adaa2" };
+    const int   bins[]        = { 372, 1114, 2972 }; // about 1, 3 and 8 kHz
+
+    FourierTransformerRadix2 fft;
+    fft.setBlockSize(fftSize);
+
+    printf("%-11s %-16s %9s", "shaper", "method", "ns/sample");
+    for(int bin : bins)
+        printf(" %8.0fHz", bin*baseRate/fftSize);
+    printf("   (alias level in dB)\n");
+
+    std::vector<double> out(numTimed);
+    double checksum = 0.0;
+    for(int s = 0; s < 4; ++s) {
+        for(int m = 0; m < NUM_METHODS; ++m) {
+            int os = (m == OVERSAMPLED) ? oversampling : 1;
+            std::vector<double> sine = tabulateSine(bins[0], os);
+            Clock::time_point start = Clock::now();
+            render(shapers[s], m, sine, numTimed, &out[0]);
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / numTimed;
+            checksum += out[numTimed-1];
+
+            printf("%-11s %-16s %9.2f", shaperNames[s], methodNames[m], ns);
+            for(int bin : bins) {
+                render(shapers[s], m, tabulateSine(bin, os), settle+fftSize, &out[0]);
+                printf(" %10.1f", aliasLevel(&out[settle], bin, fft));
+            }
+            printf("\n");
+        }
+    }
+
+    // Open303 runs the decimation filter anyway, so this part of the oversampled cost is not
+    // saved by moving the drive stage to the base rate:
+    std::vector<double> sine = tabulateSine(bins[0], oversampling);
+    EllipticQuarterBandFilter decimator;
+    Clock::time_point start = Clock::now();
+    for(int n = 0; n < numTimed; ++n) {
+        const double* in = &sine[(n % fftSize)*oversampling];
+        for(int i = 0; i < oversampling; ++i)
+            out[n] = decimator.getSample(in[i]);
+    }
+    printf("decimation filter alone: %.2f ns/sample\n",
+        std::chrono::duration<double, std::nano>(Clock::now() - start).count() / numTimed);
+    checksum += out[numTimed-1];
+
+    printf("(checksum %g)\n", checksum);
+    return 0;
+}
@@ -0,0 +1,116 @@
+// Open303FilterBenchmark.cpp
+// toneburst (the_voder@yahoo.co.uk)
+/*
+  Benchmark tool: compares the solutions of the 303 ladder in TeeBeeFilter - the standard
+  (linear) one, the zero-delay feedback one and the nonlinear one with saturating stages - plus the
+  pole-mixing modes used by the morphing filter. For each it prints the CPU time per sample at the
+  4x oversampled rate of Open303 and the peak output for a saw at increasing input levels, which
+  grows in proportion to the input in the linear modes and shows where the nonlinear ladder
+  starts to saturate. Finally it times the saturator of the nonlinear ladder on its own, over a
+  buffer (where it vectorizes) and against std::tanh.
+
+  Usage: Open303FilterBenchmark
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "../lib/Open303/Source/DSPCode/rosic_TeeBeeFilter.h"
+
+using rosic::TeeBeeFilter;
+
+static const int    oversampling = 4;
+static const double sampleRate   = oversampling*44100.0;
+static const int    period       = 1600;    // saw period in samples (about 110Hz)
+static const int    numTimed     = 4000000; // samples per timing run
+static const int    numLevel     = 200000;  // samples per level measurement
+
+typedef std::chrono::steady_clock Clock;
+
+// One period of a naive saw at the given amplitude
+static std::vector<double> tabulateSaw(double amplitude) {
+    std::vector<double> saw(period);
+    for(int n = 0; n < period; ++n)
+        saw[n] = amplitude * (2.0*n/period - 1.0);
+    return saw;
+}
+
+static void setUp(TeeBeeFilter& filter, int mode, double resonance) {
+    filter.setSampleRate(sampleRate);
+    filter.setMode(mode);
+    filter.setFeedbackHighpassCutoff(150.0);
+    filter.setCutoff(800.0, false);
+    filter.setResonance(resonance);
+}
+
+// Peak output over the last half of numLevel samples
+static double peakLevel(int mode, double resonance, double amplitude) {
+    TeeBeeFilter filter;
+    setUp(filter, mode, resonance);
+    std::vector<double> saw = tabulateSaw(amplitude);
+    double peak = 0.0;
+    for(int n = 0; n < numLevel; ++n) {
+        double y = filter.getSample(saw[n % period]);
+        if(n >= numLevel/2)
+            peak = std::max(peak, fabs(y));
+    }
+    return peak;
+}
+
+int main() {
+    const int    modes[]     = { TeeBeeFilter::TB_303, TeeBeeFilter::TB_303_ZDF, TeeBeeFilter::TB_303_NONLINEAR,
+                                 TeeBeeFilter::HP_24, TeeBeeFilter::BP_12_12 };
+    const char*  modeNames[] = { "TB_303", "TB_303_ZDF", "TB_303_NONLINEAR", "HP_24", "BP_12_12" };
+    const double levels[]    = { 0.25, 1.0, 4.0 };
+    const double resonance   = 100.0;
+
+    printf("%-17s %9s", "mode", "ns/sample");
+    for(double level : levels)
+        printf(" %9.2fin", level);
+    printf("   (peak output, resonance %.0f%%)\n", resonance);
+
+    std::vector<double> saw = tabulateSaw(1.0);
+    double checksum = 0.0;
+    for(int m = 0; m < 5; ++m) {
+        TeeBeeFilter filter;
+        setUp(filter, modes[m], resonance);
+        double y = 0.0;
+        Clock::time_point start = Clock::now();
+        for(int n = 0; n < numTimed; ++n)
+            y += filter.getSample(saw[n % period]);
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / numTimed;
+        checksum += y;
+
+        printf("%-17s %9.2f", modeNames[m], ns);
+        for(double level : levels)
+            printf(" %11.3f", peakLevel(modes[m], resonance, level));
+        printf("\n");
+    }
+
+    // the saturator alone, over a buffer:
+    std::vector<double> in(period*4), out(period*4);
+    for(size_t n = 0; n < in.size(); ++n)
+        in[n] = 4.0 * saw[n % period];
+    const int numPasses = numTimed / (int) in.size();
+    Clock::time_point start = Clock::now();
+    for(int p = 0; p < numPasses; ++p) {
+        for(size_t n = 0; n < in.size(); ++n)
+            out[n] = rosic::tanhApprox(in[n]);
+        checksum += out[p % in.size()];
+    }
+    double nsRational = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / (numPasses*in.size());
+    start = Clock::now();
+    for(int p = 0; p < numPasses; ++p) {
+        for(size_t n = 0; n < in.size(); ++n)
+            out[n] = tanh(in[n]);
+        checksum += out[p % in.size()];
+    }
+    double nsTanh = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / (numPasses*in.size());
+    printf("saturator over a buffer: rational %.2f ns/sample, std::tanh %.2f ns/sample\n", nsRational, nsTanh);
+
+    printf("(checksum %g)\n", checksum);
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Open303InterpolationSNR.cpp
+// toneburst (the_voder@yahoo.co.uk)
+/*
+  Measurement tool: runs the BlendOscillator over a range of notes and oversampling factors with
+  each wavetable interpolation method and prints the signal-to-noise ratio of the interpolation
+  error. The reference is the exact (band-limited Fourier series) value of the same mip-level at
+  the same phase, so only the interpolation error is measured - not the band-limiting itself.
+
+  Usage: Open303InterpolationSNR
+*/
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "../lib/Open303/Source/DSPCode/rosic_BlendOscillator.h"
+
+using rosic::BlendOscillator;
+using rosic::MipMappedWaveTable;
+
+static const int    N          = MipMappedWaveTable::tableLength;
+static const int    numSamples = 8192;
+static const double baseRate   = 44100.0;
+
+// Fourier series of one mip-level, for evaluating it at arbitrary phases
+struct FourierSeries {
+    std::vector<double> a, b; // cosine and sine coefficients, a[0] is DC
+
+    FourierSeries(const double* table, int numHarmonics) : a(numHarmonics+1), b(numHarmonics+1) {
+        for(int k = 0; k <= numHarmonics; ++k) {
+            double sa = 0.0, sb = 0.0;
+            for(int n = 0; n < N; ++n) {
+                double w = 2.0*PI*((k*n) % N)/N;
+                sa += table[n]*cos(w);
+                sb += table[n]*sin(w);
+            }
+            // DC and Nyquist have no mirrored negative frequency:
+            double scale = (k == 0 || 2*k == N) ? 1.0 : 2.0;
+            a[k] = scale*sa/N;
+            b[k] = scale*sb/N;
+        }
+    }
+
+    double valueAt(double phaseIndex) const {
+        double w  = 2.0*PI*phaseIndex/N;
+        double c1 = cos(w), s1 = sin(w);
+        double c  = 1.0,    s  = 0.0;
+        double y  = a[0];
+        for(size_t k = 1; k < a.size(); ++k) {
+            double cn = c*c1 - s*s1;
+            s = s*c1 + c*s1;
+            c = cn;
+            y += a[k]*c + b[k]*s;
+        }
+        return y;
+    }
+};
+
+// Same mip-level selection as BlendOscillator::getSample
+static int tableNumberFor(double increment) {
+    int tableNumber = ((int)EXPOFDBL(increment)) + 2;
+    if(tableNumber < 0)
+        tableNumber = 0;
+    if(tableNumber >= MipMappedWaveTable::numTables)
+        tableNumber = MipMappedWaveTable::numTables-1;
+    return tableNumber;
+}
+
+int main() {
+    const int         waveforms[]     = { MipMappedWaveTable::SAW303, MipMappedWaveTable::SQUARE303 };
+    const char*       waveformNames[] = { "saw303", "square303" };
+    const int         oversampling[]  = { 1, 2, 4 };
+    const int         notes[]         = { 24, 36, 48, 60, 72 };
+    const char*       methodNames[]   = { "linear", "hermite", "lagrange" };
+    const int         numMethods      = MipMappedWaveTable::NUM_INTERPOLATION_METHODS;
+
+    printf("%-10s %4s %5s", "waveform", "os", "note");
+    for(int m = 0; m < numMethods; ++m)
+        printf(" %10s", methodNames[m]);
+    printf("   (SNR in dB)\n");
+
+    for(int w = 0; w < 2; ++w) {
+        MipMappedWaveTable waveTable;
+        waveTable.setWaveform(waveforms[w]);
+
+        for(int os : oversampling) {
+            for(int note : notes) {
+                BlendOscillator oscillator;
+                oscillator.setWaveTable1(&waveTable);
+                oscillator.setWaveTable2(&waveTable);
+                oscillator.setBlendFactor(0.0);
+                oscillator.setSampleRate(os*baseRate);
+                oscillator.setFrequency(440.0*pow(2.0, (note-69)/12.0));
+                oscillator.calculateIncrement();
+
+                double increment   = oscillator.getIncrement();
+                int    tableNumber = tableNumberFor(increment);
+                FourierSeries series(waveTable.getTable(tableNumber), (N >> tableNumber)/2);
+
+                // the reference doesn't depend on the interpolation method:
+                std::vector<double> reference(numSamples);
+                double phaseIndex = 0.0;
+                for(int n = 0; n < numSamples; ++n) {
+                    while(phaseIndex >= N)
+                        phaseIndex -= N;
+                    reference[n] = series.valueAt(phaseIndex);
+                    phaseIndex  += increment;
+                }
+
+                printf("%-10s %4d %5d", waveformNames[w], os, note);
+                for(int m = 0; m < numMethods; ++m) {
+                    oscillator.setInterpolationMethod(m);
+                    oscillator.resetPhase();
+                    double signalPower = 0.0, errorPower = 0.0;
+                    for(int n = 0; n < numSamples; ++n) {
+                        double error = oscillator.getSample() - reference[n];
+                        signalPower += reference[n]*reference[n];
+                        errorPower  += error*error;
+                    }
+                    printf(" %10.1f", 10.0*log10(signalPower/errorPower));
+                }
+                printf("\n");
+            }
+        }
+    }
+    return 0;
+}
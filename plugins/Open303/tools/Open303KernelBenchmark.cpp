@@ -0,0 +1,113 @@
+// Open303KernelBenchmark.cpp
+// toneburst (the_voder@yahoo.co.uk)
+/*
+  Benchmark tool: renders an accented 303 pattern through the kernels of Open303 (see
+  Open303Kernels) for each instruction set this build has kernels for. For each one that the CPU
+  supports it prints the CPU time per output sample of the whole engine, rendering in blocks of
+  64 samples like the UGen, and the level of the difference to the generic kernels relative to
+  the signal. The variants are compiled with different instructions (e.g. fused multiply-adds),
+  so they don't match the generic kernels bit for bit. The exit status is non-zero if any of the
+  differences is louder than maxErrorLevel.
+
+  Usage: Open303KernelBenchmark
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "../lib/Open303/Source/DSPCode/rosic_Open303.h"
+#include "../lib/Open303/Source/DSPCode/tbrst_Open303Kernels.h"
+
+using rosic::Open303;
+using rosic::Open303Kernels;
+
+static const double sampleRate    = 48000.0;
+static const int    blockSize     = 64;
+static const int    stepLength    = 6016;    // samples per 16th note (about 120bpm), whole blocks
+static const int    numSteps      = 64;
+static const int    numRuns       = 9;       // timing runs per kernels, the fastest counts
+static const double maxErrorLevel = -100.0;  // dB relative to the signal
+
+typedef std::chrono::steady_clock Clock;
+
+// Renders the pattern with the selected kernels, with the cutoff sweeping once per block
+static std::vector<float> render(double& nanoseconds) {
+    const int    notes[]   = { 36, 48, 36, 39, 43, 36, 46, 48 };
+    const bool   accents[] = { true, false, false, true, false, false, true, false };
+
+    Open303 o303;
+    o303.setSampleRate(sampleRate);
+    o303.setDecay(300.0);
+    o303.setAccent(80.0);
+    o303.setResonance(85.0);
+    o303.setEnvMod(90.0);
+
+    std::vector<float> out(numSteps*stepLength);
+    Clock::time_point start = Clock::now();
+    for(int step = 0; step < numSteps; ++step) {
+        o303.triggerNote(notes[step % 8], accents[step % 8]);
+        for(int n = 0; n < stepLength; n += blockSize) {
+            if(n == stepLength*3/4/blockSize*blockSize)
+                o303.allNotesOff();
+            double sweep = (double) (step*stepLength + n) / out.size();
+            o303.setCutoff(300.0 + 1500.0*sweep);
+            Open303Kernels::render(o303, blockSize);
+            Open303Kernels::finish(o303, &out[step*stepLength + n]);
+        }
+    }
+    nanoseconds = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / out.size();
+    return out;
+}
+
+int main() {
+    const int numSets = Open303Kernels::NUM_INSTRUCTION_SETS;
+    std::vector<float> out[numSets];
+    double nanoseconds[numSets];
+
+    // the runs of all kernels take turns, so they see the same load on the machine:
+    for(int run = 0; run < numRuns; ++run) {
+        for(int set = 0; set < numSets; ++set) {
+            if(!Open303Kernels::select(set))
+                continue;
+            double ns;
+            if(run == 0)
+                out[set] = render(nanoseconds[set]);
+            else {
+                render(ns);
+                nanoseconds[set] = std::min(nanoseconds[set], ns);
+            }
+        }
+    }
+
+    const std::vector<float>& reference = out[Open303Kernels::GENERIC];
+    double signalPower = 0.0;
+    for(float x : reference)
+        signalPower += (double) x*x;
+
+    printf("%-8s %9s %12s   (detected: %s)\n", "kernels", "ns/sample", "error (dB)",
+        Open303Kernels::getName(Open303Kernels::detectInstructionSet()));
+    printf("%-8s %9.2f %12s\n", Open303Kernels::getName(Open303Kernels::GENERIC), nanoseconds[0], "-");
+    bool passed = true;
+    for(int set = Open303Kernels::GENERIC+1; set < numSets; ++set) {
+        if(!Open303Kernels::isCompiled(set))
+            continue;
+        if(!Open303Kernels::isSupported(set)) {
+            printf("%-8s %9s\n", Open303Kernels::getName(set), "(not supported by this CPU)");
+            continue;
+        }
+        double errorPower = 0.0;
+        for(size_t n = 0; n < reference.size(); ++n) {
+            double e = (double) out[set][n] - reference[n];
+            errorPower += e*e;
+        }
+        double errorLevel = errorPower > 0.0 ? 10.0*log10(errorPower / signalPower) : -INFINITY;
+        printf("%-8s %9.2f %12.1f\n", Open303Kernels::getName(set), nanoseconds[set], errorLevel);
+        if(errorLevel > maxErrorLevel)
+            passed = false;
+    }
+    printf("%s (error limit %.0f dB)\n", passed ? "passed" : "FAILED", maxErrorLevel);
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+// Open303ModulationSubRate.cpp
+// toneburst (the_voder@yahoo.co.uk)
+/*
+  Measurement tool: renders an accented 303 pattern with a fast, deep filter envelope through
+  Open303 with the envelope-driven cutoff updated every 1, 4, 8 and 16 samples (see
+  Open303::setModulationSubRate). For each sub-rate it prints the CPU time per output sample of
+  the whole engine and of the modulation path alone (the cutoff mapping and the coefficient
+  updates of the morph filter, on the same update schedule as Open303), and the level of the
+  difference to the per-sample update relative to the signal (as power and as peak). The exit
+  status is non-zero if any of the differences is louder than maxErrorLevel, as power or as peak.
+
+  Usage: Open303ModulationSubRate
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "../lib/Open303/Source/DSPCode/rosic_Open303.h"
+
+using rosic::Open303;
+using rosic::TeeBeeFilterMorph;
+
+static const double sampleRate    = 48000.0;
+static const int    stepLength    = 6000;    // samples per 16th note (120bpm)
+static const int    numSteps      = 64;
+static const double maxErrorLevel = -40.0;   // dB relative to the signal
+static const int    oversampling  = 4;
+static const double decayTime     = 200.0;   // ms, of the modeled envelope (accented notes)
+static const double attackTime    = 15.0;    // ms, time constant of the RC behind the envelope
+
+typedef std::chrono::steady_clock Clock;
+
+// Renders the pattern, calling the parameter setters for every sample like the UGen does
+static std::vector<double> render(int subRate, double& nanoseconds) {
+    const int    notes[]   = { 36, 48, 36, 39, 43, 36, 46, 48 };
+    const bool   accents[] = { true, false, false, true, false, false, true, false };
+
+    Open303 o303;
+    o303.setSampleRate(sampleRate);
+    o303.setModulationSubRate(subRate);
+    o303.setDecay(300.0);
+    o303.setAccent(80.0);
+
+    std::vector<double> out(numSteps*stepLength);
+    Clock::time_point start = Clock::now();
+    for(int step = 0; step < numSteps; ++step) {
+        o303.triggerNote(notes[step % 8], accents[step % 8]);
+        for(int n = 0; n < stepLength; ++n) {
+            if(n == stepLength*3/4)
+                o303.allNotesOff();
+            double sweep = (double) (step*stepLength + n) / out.size();
+            o303.setCutoff(300.0 + 1500.0*sweep);
+            o303.setResonance(85.0);
+            o303.setEnvMod(90.0);
+            out[step*stepLength + n] = o303.getSample();
+        }
+    }
+    nanoseconds = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / out.size();
+    return out;
+}
+
+// Times the modulation path alone: for every sample, the cutoff of an envelope shaped like the
+// accented one in Open303 is mapped to Hz with pow() and set up as a ramp of the morph filter's
+// coefficients, which is then advanced - on the same schedule as Open303::renderSampleForMode
+// (every sample during the attack, extrapolated points at the sub-rate afterwards)
+static double timeModulationPath(int subRate, double& checksum) {
+    // the envelope in octaves, computed up front so it isn't timed:
+    const int attackSamples = subRate * (int) ceil(0.001*attackTime*sampleRate / subRate);
+    std::vector<double> exponents(stepLength);
+    for(int n = 0; n < stepLength; ++n) {
+        double t = 1000.0 * n / sampleRate;
+        exponents[n] = 4.0 * (exp(-t/decayTime) - exp(-t/attackTime));
+    }
+
+    TeeBeeFilterMorph filter;
+    filter.setSampleRate(oversampling*sampleRate);
+    filter.setResonance(85.0);
+
+    Clock::time_point start = Clock::now();
+    for(int step = 0; step < numSteps; ++step) {
+        int    counter      = 0;
+        double lastExponent = NAN;
+        for(int n = 0; n < stepLength; ++n) {
+            bool point = --counter <= 0;
+            if(point || n < attackSamples) {
+                double exponent   = exponents[n];
+                int    rampLength = subRate;
+                if(n < attackSamples) {
+                    rampLength = 1;
+                    if(point)
+                        lastExponent = exponent;
+                } else if(subRate > 1) {
+                    double last  = lastExponent;
+                    lastExponent = exponent;
+                    if(std::isnan(last))
+                        rampLength = 1;
+                    else
+                        exponent += exponent - last;
+                }
+                filter.setCutoffRamp(500.0 * pow(2.0, exponent), rampLength);
+                if(point)
+                    counter = subRate;
+            }
+            filter.advanceCoefficients();
+        }
+    }
+    double nanoseconds = std::chrono::duration<double, std::nano>(Clock::now() - start).count()
+        / (numSteps*stepLength);
+    checksum += filter.getSample(1.0); // depends on the final coefficients
+    return nanoseconds;
+}
+
+int main() {
+    const int subRates[] = { 4, 8, 16 };
+
+    double nanoseconds, checksum = 0.0;
+    std::vector<double> reference = render(1, nanoseconds);
+    double signalPower = 0.0;
+    for(double x : reference)
+        signalPower += x*x;
+
+    printf("%-8s %9s %12s %12s %12s\n", "subrate", "ns/sample", "mod ns/smp", "error (dB)", "peak (dB)");
+    printf("%-8d %9.2f %12.2f %12s %12s\n", 1, nanoseconds, timeModulationPath(1, checksum), "-", "-");
+    bool passed = true;
+    for(int subRate : subRates) {
+        std::vector<double> out = render(subRate, nanoseconds);
+        double errorPower = 0.0, peakError = 0.0, peak = 0.0;
+        for(size_t n = 0; n < out.size(); ++n) {
+            double e = out[n] - reference[n];
+            errorPower += e*e;
+            peakError   = std::max(peakError, fabs(e));
+            peak        = std::max(peak, fabs(reference[n]));
+        }
+        double errorLevel     = 10.0*log10(errorPower / signalPower);
+        double peakErrorLevel = 20.0*log10(peakError / peak);
+        printf("%-8d %9.2f %12.2f %12.1f %12.1f\n", subRate, nanoseconds,
+            timeModulationPath(subRate, checksum), errorLevel, peakErrorLevel);
+        if(errorLevel > maxErrorLevel || peakErrorLevel > maxErrorLevel)
+            passed = false;
+    }
+    printf("(checksum %g)\n", checksum);
+    printf("%s (error limit %.0f dB, as power and as peak)\n", passed ? "passed" : "FAILED", maxErrorLevel);
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,96 @@
+// Open303OscillatorBenchmark.cpp
+// toneburst (the_voder@yahoo.co.uk)
+/*
+  Benchmark tool: compares the wavetable and PolyBLEP backends of the BlendOscillator, both for
+  running the oscillator (as in the oversampled loop of Open303) and for changing the shaper
+  settings of the 303 square.
+
+  Usage: Open303OscillatorBenchmark
+*/
+
+#include <chrono>
+#include <cstdio>
+
+#include "../lib/Open303/Source/DSPCode/rosic_BlendOscillator.h"
+
+using rosic::BlendOscillator;
+using rosic::MipMappedWaveTable;
+
+static const int    numSamples   = 4000000; // oversampled samples per run
+static const double sampleRate   = 4*44100.0;
+
+typedef std::chrono::steady_clock Clock;
+
+static double nanosecondsSince(Clock::time_point start, int count) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / count;
+}
+
+// Runs the oscillator like Open303::getSample does: a new increment (slowly sweeping the
+// frequency) for every 4 samples
+static double runOscillator(BlendOscillator& oscillator, double& checksum) {
+    Clock::time_point start = Clock::now();
+    double sum = 0.0;
+    for(int n = 0; n < numSamples; n += 4) {
+        oscillator.setFrequency(40.0 + (n & 0xFFFF) * 0.01);
+        oscillator.calculateIncrement();
+        for(int i = 0; i < 4; ++i)
+            sum += oscillator.getSample();
+    }
+    checksum += sum;
+    return nanosecondsSince(start, numSamples);
+}
+
+int main() {
+    MipMappedWaveTable saw303, square303;
+    saw303.setWaveform(MipMappedWaveTable::SAW303);
+    square303.setWaveform(MipMappedWaveTable::SQUARE303);
+
+    struct Setup { const char* name; int backend; int interpolation; };
+    const Setup setups[] = {
+        { "wavetable, linear",   BlendOscillator::WAVETABLE, MipMappedWaveTable::LINEAR   },
+        { "wavetable, hermite",  BlendOscillator::WAVETABLE, MipMappedWaveTable::HERMITE  },
+        { "wavetable, lagrange", BlendOscillator::WAVETABLE, MipMappedWaveTable::LAGRANGE },
+        { "polyblep",            BlendOscillator::POLYBLEP,  MipMappedWaveTable::LINEAR   },
+    };
+
+    double checksum = 0.0;
+    printf("oscillator (saw/square blend 0.85, ns per oversampled sample):\n");
+    for(const Setup& setup : setups) {
+        BlendOscillator oscillator;
+        oscillator.setWaveTable1(&saw303);
+        oscillator.setWaveTable2(&square303);
+        oscillator.setSampleRate(sampleRate);
+        oscillator.setBlendFactor(0.85);
+        oscillator.setBackend(setup.backend);
+        oscillator.setInterpolationMethod(setup.interpolation);
+        runOscillator(oscillator, checksum); // warm up
+        printf("  %-20s %8.2f\n", setup.name, runOscillator(oscillator, checksum));
+    }
+
+    // shaper changes: re-rendering the square mip-map vs. updating the PolyBLEP coefficients
+    const int numRenders = 20;
+    MipMappedWaveTable::RenderScratch scratch;
+    Clock::time_point start = Clock::now();
+    for(int i = 0; i < numRenders; ++i)
+        square303.setWaveformParameters(MipMappedWaveTable::SQUARE303, 0.5, 30.0 + i, 4.37, 180.0,
+            &scratch);
+    double renderTime = nanosecondsSince(start, numRenders);
+
+    const int numUpdates = 1000000;
+    BlendOscillator oscillator;
+    start = Clock::now();
+    for(int i = 0; i < numUpdates; ++i)
+        oscillator.setSquareShape(30.0 + (i & 15), 4.37, 180.0);
+    double updateTime = nanosecondsSince(start, numUpdates);
+
+    printf("square shaper change (us):\n");
+    printf("  %-20s %8.2f\n", "wavetable render", renderTime * 1e-3);
+    printf("  %-20s %8.4f\n", "polyblep update", updateTime * 1e-3);
+    printf("table memory per waveform: %d kB (wavetable), 0 kB (polyblep)\n",
+        (int) (MipMappedWaveTable::numTables * (MipMappedWaveTable::tableLength+4) * sizeof(double) / 1024));
+
+    // keeps the compiler from optimizing the runs away
+    if(checksum == 12345.6789)
+        printf("%g\n", checksum);
+    return 0;
+}
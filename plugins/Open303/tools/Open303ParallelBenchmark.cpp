@@ -0,0 +1,144 @@
+// Open303ParallelBenchmark.cpp
+// toneburst (the_voder@yahoo.co.uk)
+/*
+  Benchmark tool: renders numVoices Open303 basslines the way supernova runs the synths of a
+  ParGroup - each voice has its own engine, all of them read the same (cached) square-wave table,
+  and for every block of 64 samples the voices are shared out among a number of threads, which
+  wait for each other at the end of the block. For 1, 2, 4 and 8 threads it prints the wall clock
+  time, how many times faster than realtime it ran, the speedup over one thread and whether every
+  voice rendered exactly the same samples as with one thread. The exit status is non-zero if any
+  of them didn't, which would mean that the voices share mutable state.
+
+  This is the C++ counterpart of Open303ParGroupBenchmark.scd, for machines without a
+  SuperCollider install. The speedup is bounded by the number of hardware threads, which it also
+  prints.
+
+  Usage: Open303ParallelBenchmark
+*/
+
+#include <algorithm>
+#include <barrier>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "../lib/Open303/Source/DSPCode/rosic_Open303.h"
+#include "../lib/Open303/Source/DSPCode/tbrst_Open303Kernels.h"
+#include "../lib/Open303/Source/DSPCode/tbrst_WaveTableCache.h"
+
+using rosic::MipMappedWaveTable;
+using rosic::Open303;
+using rosic::Open303Kernels;
+using rosic::WaveTableCache;
+using rosic::WaveTableKey;
+
+static const double sampleRate = 48000.0;
+static const int    blockSize  = 64;
+static const int    numVoices  = 32;
+static const int    numBlocks  = 7500;    // 10 seconds
+static const int    numRuns    = 3;       // timing runs per thread count, the fastest counts
+
+typedef std::chrono::steady_clock Clock;
+
+// One bassline: its own engine and pattern, like an Open303 synth in the ParGroup
+struct Voice {
+    Open303            o303;
+    int                root;
+    int                stepBlocks;        // blocks per step
+    std::vector<float> out;
+
+    void renderBlock(int block) {
+        const int  offsets[] = { 0, 12, 0, 3, 7, 0, 10, 12 };
+        const bool accents[] = { true, false, false, true, false, false, true, false };
+        int step = block / stepBlocks;
+        if(block % stepBlocks == 0)
+            o303.triggerNote(root + offsets[step % 8], accents[step % 8]);
+        else if(block % stepBlocks == stepBlocks*3/4)
+            o303.allNotesOff();
+        Open303Kernels::render(o303, blockSize);
+        Open303Kernels::finish(o303, &out[block*blockSize]);
+    }
+};
+
+// Renders all voices with the given number of threads and returns the wall clock time in seconds
+static double render(std::vector<std::unique_ptr<Voice>>& voices, MipMappedWaveTable* squareTable,
+    int numThreads) {
+    voices.clear();
+    for(int i = 0; i < numVoices; ++i) {
+        voices.push_back(std::make_unique<Voice>());
+        Voice& voice = *voices.back();
+        voice.o303.setSampleRate(sampleRate);
+        voice.o303.setDecay(400.0);
+        voice.o303.setAccent(70.0);
+        voice.o303.setResonance(80.0);
+        voice.o303.setEnvMod(60.0);
+        voice.o303.setCutoff(400.0);
+        voice.o303.setSquareWaveTable(squareTable);
+        voice.o303.setWaveform(0.5);
+        voice.root       = 24 + (i % 24);
+        voice.stepBlocks = 80 + 8*(i % 5);
+        voice.out.assign(numBlocks*blockSize, 0.0f);
+    }
+
+    std::barrier<> endOfBlock(numThreads);
+    auto work = [&](int thread) {
+        for(int block = 0; block < numBlocks; ++block) {
+            for(int i = thread; i < numVoices; i += numThreads)
+                voices[i]->renderBlock(block);
+            endOfBlock.arrive_and_wait();
+        }
+    };
+
+    Clock::time_point start = Clock::now();
+    std::vector<std::thread> threads;
+    for(int t = 1; t < numThreads; ++t)
+        threads.emplace_back(work, t);
+    work(0);
+    for(std::thread& thread : threads)
+        thread.join();
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main() {
+    const int threadCounts[] = { 1, 2, 4, 8 };
+    const double duration = (double) numBlocks*blockSize / sampleRate;
+
+    // the square table shared by all voices, as set by the open303SquareShaper command:
+    static WaveTableCache cache;
+    WaveTableKey key = { MipMappedWaveTable::SQUARE303, 0.5, 30.0, 4.37, 180.0 };
+    MipMappedWaveTable* squareTable = cache.acquire(key);
+
+    std::vector<std::unique_ptr<Voice>> voices;
+    render(voices, squareTable, 1);
+    std::vector<std::vector<float>> reference;
+    for(const std::unique_ptr<Voice>& voice : voices)
+        reference.push_back(voice->out);
+
+    printf("%d voices, %.0f seconds at %.0fHz, %u hardware threads\n", numVoices, duration,
+        sampleRate, std::thread::hardware_concurrency());
+    printf("%7s %8s %11s %8s %10s\n", "threads", "seconds", "x realtime", "speedup", "identical");
+    bool passed = true;
+    double oneThread = 0.0;
+    for(int numThreads : threadCounts) {
+        double seconds = 0.0;
+        bool   identical = true;
+        for(int run = 0; run < numRuns; ++run) {
+            double s = render(voices, squareTable, numThreads);
+            seconds = run == 0 ? s : std::min(seconds, s);
+            for(int i = 0; i < numVoices; ++i)
+                identical = identical && voices[i]->out == reference[i];
+        }
+        if(numThreads == 1)
+            oneThread = seconds;
+        printf("%7d %8.2f %11.1f %8.2f %10s\n", numThreads, seconds, duration / seconds,
+            oneThread / seconds, identical ? "yes" : "NO");
+        passed = passed && identical;
+    }
+
+    voices.clear();
+    cache.release(squareTable);
+    printf("%s\n", passed ? "passed" : "FAILED (the voices interfere)");
+    return passed ? 0 : 1;
+}
@@ -28,7 +28,7 @@ cd build || 'exit'
 
 # Start build process
 echo "Starting build from $(pwd)"
-cmake .. -DCMAKE_BUILD_TYPE='Release' -DSC_PATH="${SC_DIR}" -DCMAKE_INSTALL_PREFIX="${INSTALL_DIR}"
+cmake .. -DCMAKE_BUILD_TYPE='Release' -DSC_PATH="${SC_DIR}" -DCMAKE_INSTALL_PREFIX="${INSTALL_DIR}" -DSUPERNOVA=OFF
 cmake --build . --config Release
 
 echo "Build complete. Installing to ${INSTALL_DIR}"
@@ -41,7 +41,7 @@ cd build || 'exit'
 
 # Start build process
 echo "Starting build from $(pwd)"
-cmake .. -DCMAKE_BUILD_TYPE='Release' -DSC_PATH="${SC_DIR}" -DCMAKE_INSTALL_PREFIX="${INSTALL_DIR}"
+cmake .. -DCMAKE_BUILD_TYPE='Release' -DSC_PATH="${SC_DIR}" -DCMAKE_INSTALL_PREFIX="${INSTALL_DIR}" -DSUPERNOVA=OFF
 cmake --build . --config Release
 
 # Check if the build was successful